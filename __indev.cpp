@@ -14,16 +14,3 @@ int main()
     GetFileExtension(file_name);
     return 0;
 }
-
-
-
-// Two dimensional distribution
-
-std::string Disribution2DSequerntial(uint64_t draw_size = uint64_t(1e3))
-{
-    resut_t* x_axis = new double[draw_size/2]();
-    resut_t* y_axis = new double[draw_size/2]();
-
-    //Draw numbers
-
-}
\ No newline at end of file
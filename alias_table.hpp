@@ -0,0 +1,464 @@
+#pragma once
+
+#include "fast_uniform.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <initializer_list>
+#include <span>
+#include <limits>
+#include <thread>
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+
+//Reference - "A Linear Algorithm for Generating Random Numbers with a Given Distribution", M. D. Vose in IEEE Transactions on Software Engineering Volume 17 Issue 9, 1991
+
+
+/** @brief Discrete distribution over the indices [0, n) with the given weights, sampled in O(1)
+ * with Walker's alias method. A replacement for `std::discrete_distribution` (O(log n) per draw)
+ * that can be passed as one of the `Dists...` of `PRNGWrapper`.
+ *
+ * The categories are split into blocks of `BlockSize`. Every block has its own alias table
+ * (Vose's construction, O(block)) and a top-level alias table picks the block by its total
+ * weight. Hence:
+ * - the blocks are built independently, in parallel, O(n) in total,
+ * - a weight update rebuilds only its block and the small top-level table,
+ * - a draw is two table lookups: one 64-bit word picks the block, one the category (a single
+ *   word if there is only one block).
+ *
+ * Every lookup is branch-free apart from the alias selection: the high half of `word * size`
+ * is the cell and the low half is compared against the 64-bit threshold of the cell. The bias
+ * of this mapping is below `size / 2^64`.
+ * `generate()` is the batched path with the same stream as repeated `operator()` calls.
+ * `serialize()` / `deserialize()` store the weights and the tables for the binary checkpoints
+ * (`checkpoint.hpp`), so restoring does not rebuild. */
+template <typename IntType = int>
+class alias_discrete_distribution
+{
+	static_assert(std::is_integral_v<IntType>, "alias_discrete_distribution requires an integer type.");
+
+public:
+
+	using result_type = IntType;
+
+	static constexpr size_t BlockSize = 4096; //!< Categories per block (64 KiB of cells)
+
+	/** @brief Parameters of the distribution - the weights. */
+	class param_type
+	{
+		std::vector<double> Weights;
+	public:
+		using distribution_type = alias_discrete_distribution;
+
+		param_type(): Weights{1.0} {}
+		explicit param_type(std::vector<double> weights): Weights(std::move(weights)) {
+			if(Weights.empty())
+				{ Weights.push_back(1.0); }
+			}
+
+		const std::vector<double>& weights() const { return Weights; }
+
+		friend bool operator==(const param_type& lhs, const param_type& rhs) {
+			return lhs.Weights == rhs.Weights;
+			}
+	};
+
+private:
+
+	/** @brief One alias table cell: accept the cell if the low word is below `Threshold`, else take `Alias`. */
+	struct Cell
+	{
+		std::uint64_t Threshold; //!< Probability of the cell scaled to 2^64
+		std::uint32_t Alias; //!< Alias index, local to the block
+		std::uint32_t Pad = 0;
+	};
+
+	static_assert(sizeof(Cell) == 16, "alias_discrete_distribution::Cell must not contain padding.");
+
+	std::vector<double> Weights; //!< Weights of all the categories
+	std::vector<Cell> Cells; //!< Alias tables of all the blocks, block `b` starts at `b * BlockSize`
+	std::vector<double> BlockWeights; //!< Total weight of every block
+	std::vector<Cell> Top; //!< Alias table over the blocks
+
+	static constexpr size_t Chunk = 256; //!< Draws per step of `generate()`
+
+public:
+
+	//0
+	/** @brief Constructor -> A single category with weight 1. */
+	alias_discrete_distribution(): alias_discrete_distribution(param_type()) {}
+
+	/** @brief Constructor -> Builds the tables of `weights` on `threads` threads (0 for all the cores).
+	 * \attention The weights must be non-negative, finite and not all zero. An empty list is a
+	 * single category. The number of categories must fit `IntType`. */
+	explicit alias_discrete_distribution(std::span<const double> weights, size_t threads = 1):
+		Weights(weights.begin(), weights.end()) { build(threads); }
+
+	/** @brief Constructor -> Takes over the weights without a copy. */
+	explicit alias_discrete_distribution(std::vector<double>&& weights, size_t threads = 1):
+		Weights(std::move(weights)) { build(threads); }
+
+	alias_discrete_distribution(std::initializer_list<double> weights):
+		Weights(weights) { build(1); }
+
+	explicit alias_discrete_distribution(const param_type& param, size_t threads = 1):
+		Weights(param.weights()) { build(threads); }
+
+	//1
+	/** @brief The distribution does not cache values, hence there is nothing to reset. */
+	void reset() {}
+
+	//2
+	param_type param() const { return param_type(Weights); }
+	void param(const param_type& param) { Weights = param.weights(); build(1); }
+	result_type min() const { return 0; }
+	result_type max() const { return static_cast<result_type>(Weights.size() - 1); }
+	size_t size() const { return Weights.size(); }
+	const std::vector<double>& weights() const { return Weights; }
+
+	/** @brief Normalized probabilities of all the categories. */
+	std::vector<double> probabilities() const {
+		double total = 0.0;
+		for(double w : BlockWeights)
+			{ total += w; }
+		std::vector<double> p(Weights.size(), 1.0 / double(Weights.size()));
+		if(total > 0.0)
+		{
+			for(size_t i = 0; i < p.size(); i++)
+				{ p[i] = Weights[i] / total; }
+		}
+		return p;
+		}
+
+	//3
+	/** @brief Draw one index. */
+	template <class URBG>
+	__attribute__((flatten)) result_type operator()(URBG& engine) {
+		using Bits = EngineBits<URBG>;
+		size_t block = 0;
+		if(Top.size() > 1)
+			{ block = lookup(Top.data(), Top.size(), Bits::word64(engine)); }
+		const size_t begin = block * BlockSize;
+		return static_cast<result_type>(begin + lookup(Cells.data() + begin, block_size(block), Bits::word64(engine)));
+		}
+
+	//4
+	/** @brief Batched path. Fills the span with the same indices that repeated calls of
+	 * `operator()` would return and leaves the engine in the same state. Every draw takes a
+	 * fixed number of words, which are read in blocks; the cells of a chunk are prefetched
+	 * before they are resolved, so the cache misses of large tables overlap. */
+	template <class URBG>
+	void generate(URBG& engine, std::span<result_type> out) {
+		using Bits = EngineBits<URBG>;
+		const size_t words_per_draw = (Top.size() > 1) ? 2 : 1;
+		std::uint64_t words[2 * Chunk];
+		size_t index[Chunk];
+		std::uint64_t low[Chunk];
+
+		for(size_t begin = 0; begin < out.size(); begin += Chunk)
+		{
+			const size_t n = std::min(Chunk, out.size() - begin);
+			Bits::fill64(engine, std::span<std::uint64_t>(words, words_per_draw * n));
+
+			//Cell of every draw
+			for(size_t k = 0; k < n; k++)
+			{
+				size_t block = 0;
+				if(words_per_draw == 2)
+					{ block = lookup(Top.data(), Top.size(), words[2 * k]); }
+				const size_t first = block * BlockSize;
+				const size_t cell = mul_64x64(words[words_per_draw * k + words_per_draw - 1], block_size(block), low[k]);
+				index[k] = first + cell;
+				__builtin_prefetch(Cells.data() + index[k]);
+			}
+
+			//Accept the cell or take its alias
+			for(size_t k = 0; k < n; k++)
+			{
+				const Cell& c = Cells[index[k]];
+				const size_t first = index[k] / BlockSize * BlockSize;
+				out[begin + k] = static_cast<result_type>(low[k] < c.Threshold ? index[k] : first + c.Alias);
+			}
+		}
+		}
+
+	//5
+	/** @brief Sets the weight of category `i` and rebuilds its block and the top-level table. */
+	void update(size_t i, double weight) {
+		Weights[i] = weight;
+		build_block(i / BlockSize);
+		build_top();
+		}
+
+	/** @brief Sets `weights[k]` for category `indices[k]`. Every changed block is rebuilt once,
+	 * on `threads` threads (0 for all the cores), then the top-level table. */
+	void update(std::span<const size_t> indices, std::span<const double> weights, size_t threads = 1) {
+		std::vector<std::uint8_t> dirty(BlockWeights.size(), 0);
+		for(size_t k = 0; k < indices.size(); k++)
+		{
+			Weights[indices[k]] = weights[k];
+			dirty[indices[k] / BlockSize] = 1;
+		}
+
+		std::vector<size_t> blocks;
+		for(size_t b = 0; b < dirty.size(); b++)
+		{
+			if(dirty[b])
+				{ blocks.push_back(b); }
+		}
+		parallel_blocks(blocks.size(), threads, [this, &blocks](size_t k) { build_block(blocks[k]); });
+		build_top();
+		}
+
+	/** @brief Sets the weights of the categories [first, first + weights.size()). */
+	void update(size_t first, std::span<const double> weights, size_t threads = 1) {
+		if(weights.empty())
+			{ return; }
+		std::copy(weights.begin(), weights.end(), Weights.begin() + first);
+		const size_t begin = first / BlockSize;
+		const size_t end = (first + weights.size() - 1) / BlockSize + 1;
+		parallel_blocks(end - begin, threads, [this, begin](size_t k) { build_block(begin + k); });
+		build_top();
+		}
+
+	//6
+	/** @brief Appends the weights and the tables to a binary checkpoint record (`checkpoint_put()`). */
+	void serialize(std::vector<std::byte>& buffer) const {
+		const std::uint64_t n = Weights.size();
+		put_bytes(buffer, &n, sizeof(n));
+		put_bytes(buffer, Weights.data(), n * sizeof(double));
+		put_bytes(buffer, Cells.data(), n * sizeof(Cell));
+		put_bytes(buffer, BlockWeights.data(), BlockWeights.size() * sizeof(double));
+		put_bytes(buffer, Top.data(), Top.size() * sizeof(Cell));
+		}
+
+	/** @brief Reads the state written by `serialize()` (`checkpoint_get()`). Returns false and
+	 * leaves the distribution unchanged if the record is too short, the number of categories
+	 * does not fit `IntType`, or an alias points outside its table. */
+	bool deserialize(std::span<const std::byte> record, size_t& offset) {
+		std::uint64_t n = 0;
+		if(record.size() < offset + sizeof(n))
+			{ return false; }
+		std::memcpy(&n, record.data() + offset, sizeof(n));
+
+		//n is bounded by the record size first, so the byte count cannot overflow
+		if(n == 0 || n > record.size() || n - 1 > std::uint64_t(std::numeric_limits<IntType>::max()))
+			{ return false; }
+		const size_t blocks = block_count(n);
+		const size_t bytes = sizeof(n) + n * (sizeof(double) + sizeof(Cell)) + blocks * (sizeof(double) + sizeof(Cell));
+		if(record.size() < offset + bytes)
+			{ return false; }
+
+		std::vector<double> weights, block_weights;
+		std::vector<Cell> cells, top;
+		size_t pos = offset + sizeof(n);
+		get_bytes(record, pos, weights, n);
+		get_bytes(record, pos, cells, n);
+		get_bytes(record, pos, block_weights, blocks);
+		get_bytes(record, pos, top, blocks);
+
+		for(size_t b = 0; b < blocks; b++)
+		{
+			const size_t size = std::min<size_t>(BlockSize, n - b * BlockSize);
+			for(size_t i = 0; i < size; i++)
+			{
+				if(cells[b * BlockSize + i].Alias >= size)
+					{ return false; }
+			}
+			if(top[b].Alias >= blocks)
+				{ return false; }
+		}
+
+		Weights = std::move(weights);
+		Cells = std::move(cells);
+		BlockWeights = std::move(block_weights);
+		Top = std::move(top);
+		offset = pos;
+		return true;
+		}
+
+	/** @brief Distributions compare equal if their weights are equal. */
+	friend bool operator==(const alias_discrete_distribution& lhs, const alias_discrete_distribution& rhs) {
+		return lhs.Weights == rhs.Weights;
+		}
+
+	/** @brief Writes the distribution state (number of categories and weights) as text. */
+	template <class CharT, class Traits>
+	friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const alias_discrete_distribution& dist) {
+		const auto flags = os.flags();
+		const auto precision = os.precision();
+		os.flags(std::ios_base::scientific | std::ios_base::left);
+		os.precision(std::numeric_limits<double>::max_digits10);
+
+		os << dist.Weights.size();
+		for(double w : dist.Weights)
+			{ os << os.widen(' ') << w; }
+
+		os.flags(flags);
+		os.precision(precision);
+		return os;
+		}
+
+	/** @brief Reads the distribution state written by `operator<<` and rebuilds the tables. */
+	template <class CharT, class Traits>
+	friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, alias_discrete_distribution& dist) {
+		const auto flags = is.flags();
+		is.flags(std::ios_base::dec | std::ios_base::skipws);
+
+		size_t n = 0;
+		if(is >> n)
+		{
+			std::vector<double> weights(n);
+			for(auto& w : weights)
+				{ is >> w; }
+			if(is)
+				{ dist.param(param_type(std::move(weights))); }
+		}
+
+		is.flags(flags);
+		return is;
+		}
+
+private:
+//Helper Functions
+
+	static size_t block_count(size_t n) { return (n + BlockSize - 1) / BlockSize; }
+
+	size_t block_size(size_t block) const {
+		return std::min(BlockSize, Weights.size() - block * BlockSize);
+		}
+
+	/** @brief Index drawn from the alias table `cells` of `size` cells with one word. */
+	static size_t lookup(const Cell* cells, size_t size, std::uint64_t word) __attribute__((always_inline)) {
+		std::uint64_t low;
+		const size_t i = mul_64x64(word, size, low);
+		return (low < cells[i].Threshold) ? i : cells[i].Alias;
+		}
+
+	/** @brief Vose's construction of the alias table of `weights` into `cells`. Returns the total weight.
+	 * `work` must hold `weights.size()` indices. */
+	static double build_table(std::span<const double> weights, Cell* cells, std::uint32_t* work) {
+		const size_t n = weights.size();
+		double total = 0.0;
+		for(double w : weights)
+			{ total += w; }
+
+		const double scale = (total > 0.0) ? double(n) / total : 0.0;
+		auto probability = [&](size_t i) { return (total > 0.0) ? weights[i] * scale : 1.0; };
+
+		//Small cells from the front of `work`, large cells from the back
+		size_t small = 0, large = n;
+		std::vector<double> scaled(n);
+		for(size_t i = 0; i < n; i++)
+		{
+			scaled[i] = probability(i);
+			if(scaled[i] < 1.0)
+				{ work[small++] = std::uint32_t(i); }
+			else
+				{ work[--large] = std::uint32_t(i); }
+		}
+
+		//Pair every small cell with a large one, the remainder of the large cell is reclassified
+		size_t s = 0;
+		while(s < small && large < n)
+		{
+			const std::uint32_t l = work[s++];
+			const std::uint32_t g = work[large];
+			cells[l] = {threshold(scaled[l]), g};
+			scaled[g] = (scaled[g] + scaled[l]) - 1.0;
+			if(scaled[g] < 1.0)
+			{
+				large++;
+				work[small++] = g;
+			}
+		}
+
+		//Leftovers are full cells up to rounding
+		for(; s < small; s++)
+			{ cells[work[s]] = {std::numeric_limits<std::uint64_t>::max(), work[s]}; }
+		for(; large < n; large++)
+			{ cells[work[large]] = {std::numeric_limits<std::uint64_t>::max(), work[large]}; }
+
+		return total;
+		}
+
+	/** @brief Probability in [0, 1] scaled to 2^64, saturated. */
+	static std::uint64_t threshold(double p) {
+		const double scaled = p * 0x1.0p64;
+		if(!(scaled < 0x1.0p64))
+			{ return std::numeric_limits<std::uint64_t>::max(); }
+		return (scaled > 0.0) ? static_cast<std::uint64_t>(scaled) : 0;
+		}
+
+	void build_block(size_t block) {
+		const size_t begin = block * BlockSize;
+		const size_t n = block_size(block);
+		std::uint32_t work[BlockSize];
+		BlockWeights[block] = build_table(std::span<const double>(Weights.data() + begin, n), Cells.data() + begin, work);
+		}
+
+	void build_top() {
+		std::vector<std::uint32_t> work(BlockWeights.size());
+		build_table(BlockWeights, Top.data(), work.data());
+		}
+
+	/** @brief Builds all the tables, the blocks on `threads` threads (0 for all the cores). */
+	void build(size_t threads) {
+		if(Weights.empty())
+			{ Weights.push_back(1.0); }
+		const size_t blocks = block_count(Weights.size());
+		Cells.assign(Weights.size(), Cell{});
+		BlockWeights.assign(blocks, 0.0);
+		Top.assign(blocks, Cell{});
+
+		parallel_blocks(blocks, threads, [this](size_t b) { build_block(b); });
+		build_top();
+		}
+
+	/** @brief Calls `fn(k)` for k in [0, count), contiguous ranges on up to `threads` threads. */
+	template <class Fn>
+	static void parallel_blocks(size_t count, size_t threads, Fn&& fn) {
+		if(threads == 0)
+			{ threads = std::max<size_t>(1, std::thread::hardware_concurrency()); }
+		threads = std::min(threads, count);
+
+		auto worker = [&](size_t t) {
+			for(size_t k = count * t / threads; k < count * (t + 1) / threads; k++)
+				{ fn(k); }
+		};
+
+		if(threads <= 1)
+		{
+			for(size_t k = 0; k < count; k++)
+				{ fn(k); }
+			return;
+		}
+
+		std::vector<std::thread> pool;
+		for(size_t t = 1; t < threads; t++)
+			{ pool.emplace_back(worker, t); }
+		worker(0);
+		for(auto& thread : pool)
+			{ thread.join(); }
+		}
+
+	static void put_bytes(std::vector<std::byte>& buffer, const void* data, size_t bytes) {
+		const size_t offset = buffer.size();
+		buffer.resize(offset + bytes);
+		if(bytes != 0)
+			{ std::memcpy(buffer.data() + offset, data, bytes); }
+		}
+
+	template <typename Type>
+	static void get_bytes(std::span<const std::byte> record, size_t& offset, std::vector<Type>& out, size_t count) {
+		out.resize(count);
+		if(count != 0)
+			{ std::memcpy(out.data(), record.data() + offset, count * sizeof(Type)); }
+		offset += count * sizeof(Type);
+		}
+};
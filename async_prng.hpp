@@ -0,0 +1,341 @@
+#pragma once
+
+#include "new_wrapper.hpp"
+#include "parallel.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <span>
+#include <bit>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include <random>
+#include <string>
+#include <stdexcept>
+
+
+/** @brief Lock-free single-producer / single-consumer ring buffer. The capacity is a power of
+ * two and the indices run freely (wrapping at `size_t`), so full and empty are told apart without
+ * a spare slot. The producer and the consumer own one cache line each - their index and a cached
+ * copy of the other side's index, which is only re-read (acquire) when the cached copy says
+ * the ring is full or empty. Both sides are wait-free.
+ * The producer writes in place: `write_region()` returns contiguous free slots and `commit()`
+ * publishes them. */
+template <typename Type>
+class SPSCRing
+{
+	static_assert(std::is_trivially_copyable_v<Type>, "SPSCRing requires a trivially copyable type.");
+
+	struct alignas(PRNGW_CACHE_LINE) Side
+	{
+		std::atomic<size_t> Index{0}; //!< Own index, written by the owner only
+		size_t Cached = 0; //!< Last seen index of the other side
+	};
+
+	Side Consumer; //!< Head - next slot to read
+	Side Producer; //!< Tail - next slot to write
+	size_t Capacity; //!< Number of slots, a power of two
+	size_t Mask; //!< Capacity - 1
+	std::unique_ptr<Type[]> Buffer; //!< Slots
+
+public:
+
+	//0
+	/** @brief Constructor -> Room for at least `capacity` values (rounded up to a power of two). */
+	explicit SPSCRing(size_t capacity):
+		Capacity(std::bit_ceil(std::max<size_t>(capacity, 2))), Mask(Capacity - 1), Buffer(new Type[Capacity])
+	{}
+
+	SPSCRing(const SPSCRing&) = delete;
+	SPSCRing& operator=(const SPSCRing&) = delete;
+
+	//1
+	size_t capacity() const { return Capacity; }
+
+	/** @brief Number of values in the ring. Exact on either side, a snapshot elsewhere. */
+	size_t size() const {
+		return Producer.Index.load(std::memory_order_acquire) - Consumer.Index.load(std::memory_order_acquire);
+		}
+
+//Consumer side
+
+	//2
+	/** @brief Pops one value. Returns false if the ring is empty. */
+	bool pop(Type& value) {
+		const size_t head = Consumer.Index.load(std::memory_order_relaxed);
+		if(head == Consumer.Cached)
+		{
+			Consumer.Cached = Producer.Index.load(std::memory_order_acquire);
+			if(head == Consumer.Cached)
+				{ return false; }
+		}
+		value = Buffer[head & Mask];
+		Consumer.Index.store(head + 1, std::memory_order_release);
+		return true;
+		}
+
+	//3
+	/** @brief Pops up to `out.size()` values (at most two `memcpy`). Returns the number popped. */
+	size_t pop_n(std::span<Type> out) {
+		const size_t head = Consumer.Index.load(std::memory_order_relaxed);
+		if(Consumer.Cached - head < out.size())
+			{ Consumer.Cached = Producer.Index.load(std::memory_order_acquire); }
+
+		const size_t n = std::min(out.size(), Consumer.Cached - head);
+		const size_t first = std::min(n, Capacity - (head & Mask));
+		std::memcpy(out.data(), Buffer.get() + (head & Mask), first * sizeof(Type));
+		std::memcpy(out.data() + first, Buffer.get(), (n - first) * sizeof(Type));
+		Consumer.Index.store(head + n, std::memory_order_release);
+		return n;
+		}
+
+//Producer side
+
+	//4
+	/** @brief Contiguous free slots at the tail (up to the end of the buffer). Empty if the ring is full. */
+	std::span<Type> write_region() {
+		const size_t tail = Producer.Index.load(std::memory_order_relaxed);
+		if(tail - Producer.Cached == Capacity)
+			{ Producer.Cached = Consumer.Index.load(std::memory_order_acquire); }
+
+		const size_t free = Capacity - (tail - Producer.Cached);
+		return {Buffer.get() + (tail & Mask), std::min(free, Capacity - (tail & Mask))};
+		}
+
+	//5
+	/** @brief Publishes the first `n` slots of the last `write_region()`. */
+	void commit(size_t n) {
+		Producer.Index.store(Producer.Index.load(std::memory_order_relaxed) + n, std::memory_order_release);
+		}
+
+	//6
+	/** @brief Pushes one value. Returns false if the ring is full. */
+	bool push(const Type& value) {
+		std::span<Type> region = write_region();
+		if(region.empty())
+			{ return false; }
+		region[0] = value;
+		commit(1);
+		return true;
+		}
+};
+
+
+/** @brief Settings of `AsyncPRNG`. */
+struct AsyncConfig
+{
+	size_t Capacity = size_t(1) << 16; //!< Values per ring (rounded up to a power of two)
+	size_t LowWatermark = 0; //!< The producer refills a ring that falls below this (0 - half the capacity)
+	size_t HighWatermark = 0; //!< and fills it up to this (0 - the capacity)
+	size_t Batch = 4096; //!< Largest number of values generated by one bulk call
+	std::chrono::microseconds Poll{20}; //!< Sleep of the idle producer - bounds the refill latency
+};
+
+
+/** @brief Underrun statistics of one ring, see `AsyncPRNG`. */
+struct AsyncUnderruns
+{
+	std::uint64_t Events = 0; //!< Pops that found fewer values than requested
+	std::uint64_t Missing = 0; //!< Values requested but not available
+};
+
+
+/** @brief Moves generation off the consumer's critical path: a producer thread keeps two SPSC
+ * rings of pre-generated uniform and gaussian numbers filled with the bulk paths of the wrapper
+ * (`uni_fill()`, `gauss_fill()`), and the consumer pops them wait-free.
+ *
+ * - Both rings are filled before the constructor returns.
+ * - The producer refills a ring once it falls below the low watermark, up to the high watermark,
+ *   and sleeps `Poll` when neither needs refilling. The low watermark should cover the largest
+ *   burst the consumer draws within one poll interval.
+ * - A pop that finds too few values never waits: it returns what is there and counts an
+ *   underrun (`uni_underruns()`, `gauss_underruns()`), so the consumer can tell that it outran
+ *   the producer and fall back or resize the rings.
+ *
+ * Each ring has its own wrapper, seeded with `new_master_seed(master_seed, 2 * stream)` (uniform)
+ * and `new_master_seed(master_seed, 2 * stream + 1)` (gaussian), so both streams are reproducible
+ * regardless of the producer's timing.
+ *  PRNGType - PRNG Engine, must jump by 2^StreamShift (`has_stream_jump_v`: Mersenne Twister,
+ *  counter-based, xoshiro256, pcg64 - not wyrand).
+ *  GaussDist - Gaussian distribution of the wrappers (optional).
+ *  Dists - Additional distributions of the wrappers (optional).
+ * \attention One consumer thread. The wrappers belong to the producer while it runs; they are
+ * ahead of the consumed values by the contents of the rings. */
+template <class PRNGType, class GaussDist = std::normal_distribution<double>, class... Dists>
+class AsyncPRNG
+{
+	static_assert(has_stream_jump_v<PRNGType>,
+	              "AsyncPRNG requires an engine that jumps by 2^StreamShift to separate the uniform and gaussian streams.");
+
+public:
+
+	using wrapper_type = PRNGWrapper<PRNGType, 0, GaussDist, Dists...>; //!< Wrapper of the producer
+
+private:
+
+	wrapper_type Uni_source; //!< Producer of the uniform ring
+	wrapper_type Gauss_source; //!< Producer of the gaussian ring
+	AsyncConfig Config; //!< Watermarks and poll interval
+	SPSCRing<double> Uni_ring;
+	SPSCRing<double> Gauss_ring;
+
+	alignas(PRNGW_CACHE_LINE) std::atomic<std::uint64_t> Uni_events{0}; //!< Written by the consumer only
+	std::atomic<std::uint64_t> Uni_missing{0};
+	std::atomic<std::uint64_t> Gauss_events{0};
+	std::atomic<std::uint64_t> Gauss_missing{0};
+
+	alignas(PRNGW_CACHE_LINE) std::atomic<bool> Running{false}; //!< Producer keeps running while set
+	std::thread Producer; //!< Producer thread
+
+public:
+
+	//0
+	/** @brief Constructor -> Seeds both wrappers, fills both rings and starts the producer.
+	 * Throws `std::runtime_error` if a wrapper cannot be seeded (the jump to its stream failed).
+	 * @param master_seed Master seed of the two streams.
+	 * @param stream Index of this generator - distinct indices give non-overlapping streams. */
+	AsyncPRNG(std::uint64_t master_seed, std::uint64_t stream = 0, AsyncConfig config = {}):
+		Config(config), Uni_ring(config.Capacity), Gauss_ring(config.Capacity)
+	{
+		Config.Capacity = Uni_ring.capacity();
+		if(Config.HighWatermark == 0 || Config.HighWatermark > Config.Capacity)
+			{ Config.HighWatermark = Config.Capacity; }
+		if(Config.LowWatermark == 0 || Config.LowWatermark > Config.HighWatermark)
+			{ Config.LowWatermark = Config.HighWatermark / 2; }
+		if(Config.Batch == 0)
+			{ Config.Batch = Config.HighWatermark; }
+
+		Uni_source.set_compact_seeds(true);
+		Gauss_source.set_compact_seeds(true);
+		if(Uni_source.new_master_seed(master_seed, 2 * stream) != wrapper_type::Success ||
+		   Gauss_source.new_master_seed(master_seed, 2 * stream + 1) != wrapper_type::Success)
+			{ throw std::runtime_error("AsyncPRNG: cannot jump to stream " + std::to_string(stream)); }
+		start();
+	}
+
+	AsyncPRNG(const AsyncPRNG&) = delete;
+	AsyncPRNG& operator=(const AsyncPRNG&) = delete;
+
+	/** @brief Destructor -> Stops the producer. */
+	~AsyncPRNG() { stop(); }
+
+	//1
+	/** @brief Pops one uniform number. Returns false (and counts an underrun) if the ring is empty. */
+	bool pop_uni(double& x) {
+		return counted(Uni_ring.pop(x), 1, Uni_events, Uni_missing);
+		}
+
+	/** @brief Pops one gaussian number. Returns false (and counts an underrun) if the ring is empty. */
+	bool pop_gauss(double& x) {
+		return counted(Gauss_ring.pop(x), 1, Gauss_events, Gauss_missing);
+		}
+
+	//2
+	/** @brief Pops up to `out.size()` uniform numbers. Returns the number popped; a short pop counts an underrun. */
+	size_t pop_uni_n(std::span<double> out) {
+		const size_t n = Uni_ring.pop_n(out);
+		counted(n == out.size(), out.size() - n, Uni_events, Uni_missing);
+		return n;
+		}
+
+	/** @brief Pops up to `out.size()` gaussian numbers. Returns the number popped; a short pop counts an underrun. */
+	size_t pop_gauss_n(std::span<double> out) {
+		const size_t n = Gauss_ring.pop_n(out);
+		counted(n == out.size(), out.size() - n, Gauss_events, Gauss_missing);
+		return n;
+		}
+
+	//3
+	size_t available_uni() const { return Uni_ring.size(); }
+	size_t available_gauss() const { return Gauss_ring.size(); }
+	const AsyncConfig& config() const { return Config; }
+
+	//4
+	/** @brief Underruns of the uniform ring since the construction. */
+	AsyncUnderruns uni_underruns() const {
+		return {Uni_events.load(std::memory_order_relaxed), Uni_missing.load(std::memory_order_relaxed)};
+		}
+
+	/** @brief Underruns of the gaussian ring since the construction. */
+	AsyncUnderruns gauss_underruns() const {
+		return {Gauss_events.load(std::memory_order_relaxed), Gauss_missing.load(std::memory_order_relaxed)};
+		}
+
+	//5
+	/** @brief Fills both rings up to the high watermark and starts the producer (no-op if running). */
+	void start() {
+		if(Running.load(std::memory_order_acquire))
+			{ return; }
+		refill(Uni_ring, Uni_source, true);
+		refill(Gauss_ring, Gauss_source, false);
+		Running.store(true, std::memory_order_release);
+		Producer = std::thread([this]() { produce(); });
+		}
+
+	/** @brief Stops the producer. The rings keep their values and can still be popped. */
+	void stop() {
+		Running.store(false, std::memory_order_release);
+		if(Producer.joinable())
+			{ Producer.join(); }
+		}
+
+	//6
+	/** @brief Wrappers of the two rings, e.g. for checkpoints.
+	 * \attention Only while the producer is stopped. */
+	wrapper_type& uni_source() { return Uni_source; }
+	wrapper_type& gauss_source() { return Gauss_source; }
+
+private:
+//Helper Functions
+
+	/** @brief Producer loop. */
+	void produce() {
+		while(Running.load(std::memory_order_acquire))
+		{
+			bool busy = false;
+			if(Uni_ring.size() < Config.LowWatermark)
+				{ busy |= refill(Uni_ring, Uni_source, true); }
+			if(Gauss_ring.size() < Config.LowWatermark)
+				{ busy |= refill(Gauss_ring, Gauss_source, false); }
+			if(!busy)
+				{ std::this_thread::sleep_for(Config.Poll); }
+		}
+		}
+
+	/** @brief Generates directly into the ring until it holds `HighWatermark` values. */
+	bool refill(SPSCRing<double>& ring, wrapper_type& source, bool uniform) {
+		bool filled = false;
+		size_t size = ring.size();
+		while(size < Config.HighWatermark)
+		{
+			std::span<double> region = ring.write_region();
+			const size_t n = std::min({region.size(), Config.HighWatermark - size, Config.Batch});
+			if(n == 0)
+				{ break; }
+			if(uniform)
+				{ source.uni_fill(region.first(n)); }
+			else
+				{ source.gauss_fill(region.first(n)); }
+			ring.commit(n);
+			filled = true;
+			size = ring.size();
+		}
+		return filled;
+		}
+
+	/** @brief Counts an underrun of `missing` values unless `ok`; single writer, hence load + store. */
+	static bool counted(bool ok, size_t missing, std::atomic<std::uint64_t>& events, std::atomic<std::uint64_t>& missed) {
+		if(!ok)
+		{
+			events.store(events.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			missed.store(missed.load(std::memory_order_relaxed) + missing, std::memory_order_relaxed);
+		}
+		return ok;
+		}
+};
@@ -0,0 +1,247 @@
+//Benchmark suite of the PRNGWrapper library.
+//Build - make bench (or g++ -std=c++20 -O3 -march=native -pthread -I<nlohmann/json include dir> bench.cpp -o bench)
+//Run   - ./bench [repetitions] [threads]
+
+#include "new_wrapper.hpp"
+#include "prng_pool.hpp"
+#include "sfmt.hpp"
+#include "counter_engines.hpp"
+#include "small_engines.hpp"
+#include "async_prng.hpp"
+#include "ziggurat.hpp"
+#include "bench.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdlib>
+#include <cstdio>
+
+
+constexpr size_t Draws = size_t(1) << 20; //!< Draws per repetition of the generation benchmarks
+constexpr size_t Seedings = 64; //!< Seedings per repetition
+constexpr size_t StreamSeedings = 4; //!< Substream seedings per repetition (a Mersenne Twister jump by 2^64 takes ~0.2 s)
+constexpr size_t Checkpoints = 16; //!< Wrappers per checkpoint file
+constexpr size_t WarmupLength = 100000; //!< Numbers discarded by the warm-up benchmark
+
+
+/** @brief Generation, seeding, warm-up and checkpoint benchmarks of one engine and gaussian distribution. */
+template <class PRNGType, class GaussDist>
+void bench_wrapper(const std::string& name, BenchConfig config, std::vector<BenchResult>& results)
+{
+	using Wrapper = PRNGWrapper<PRNGType, 0, GaussDist>;
+	using result_type = typename PRNGType::result_type;
+
+	Wrapper w;
+	w.new_master_seed(12345);
+
+	std::vector<result_type> raw(Draws);
+	std::vector<double> values(Draws);
+
+	//Scalar calls
+	results.push_back(bench_run(name + " engine()", Draws, [&]() {
+		for(size_t i = 0; i < Draws; i++)
+			{ do_not_optimize(w.Engine()); }
+	}, config));
+
+	results.push_back(bench_run(name + " uni()", Draws, [&]() {
+		for(size_t i = 0; i < Draws; i++)
+			{ do_not_optimize(w.uni()); }
+	}, config));
+
+	results.push_back(bench_run(name + " gauss()", Draws, [&]() {
+		for(size_t i = 0; i < Draws; i++)
+			{ do_not_optimize(w.gauss()); }
+	}, config));
+
+	//Bulk calls
+	results.push_back(bench_run(name + " engine_fill()", Draws, [&]() {
+		w.engine_fill(std::span<result_type>(raw));
+		do_not_optimize(raw.data());
+	}, config));
+
+	results.push_back(bench_run(name + " uni_fill()", Draws, [&]() {
+		w.uni_fill(std::span<double>(values));
+		do_not_optimize(values.data());
+	}, config));
+
+	results.push_back(bench_run(name + " gauss_fill()", Draws, [&]() {
+		w.gauss_fill(std::span<double>(values));
+		do_not_optimize(values.data());
+	}, config));
+
+	//Seeding and warm-up
+	results.push_back(bench_run(name + " new_master_seed()", Seedings, [&]() {
+		for(size_t i = 0; i < Seedings; i++)
+			{ do_not_optimize(w.new_master_seed(i)); }
+	}, config));
+
+	results.push_back(bench_run(name + " new_master_seed(stream)", StreamSeedings, [&]() {
+		for(size_t i = 0; i < StreamSeedings; i++)
+			{ do_not_optimize(w.new_master_seed(12345, i + 1)); }
+	}, config));
+
+	results.push_back(bench_run(name + " new_seeds()", Seedings, [&]() {
+		for(size_t i = 0; i < Seedings; i++)
+			{ do_not_optimize(w.new_seeds(false)); }
+	}, config));
+
+	results.push_back(bench_run(name + " warm_up(" + std::to_string(WarmupLength) + ")", 1, [&]() {
+		do_not_optimize(w.warm_up(WarmupLength));
+	}, config));
+
+	//Checkpoints - Checkpoints wrappers per file
+	std::vector<Wrapper> streams(Checkpoints);
+	std::vector<Wrapper*> pointers;
+	for(size_t i = 0; i < Checkpoints; i++)
+	{
+		streams[i].new_master_seed(12345, i);
+		pointers.push_back(&streams[i]);
+	}
+	const std::string ckpt = "bench_" + std::to_string(std::hash<std::string>{}(name)) + ".ckpt";
+	const std::string json = "bench_" + std::to_string(std::hash<std::string>{}(name)) + ".json";
+
+	results.push_back(bench_run(name + " save_checkpoint()", Checkpoints, [&]() {
+		do_not_optimize(Wrapper::save_checkpoint(ckpt, pointers));
+	}, config));
+
+	results.push_back(bench_run(name + " load_checkpoint()", Checkpoints, [&]() {
+		do_not_optimize(Wrapper::load_checkpoint(ckpt, pointers));
+	}, config));
+
+	{
+		CheckpointWriter writer;
+		results.push_back(bench_run(name + " save_checkpoint_async() [caller]", Checkpoints, [&]() {
+			auto done = Wrapper::save_checkpoint_async(writer, ckpt, pointers);
+			do_not_optimize(done);
+		}, config));
+	}
+
+	results.push_back(bench_run(name + " save_state() [json]", 1, [&]() {
+		do_not_optimize(w.save_state(json));
+	}, config));
+
+	results.push_back(bench_run(name + " load_state() [json]", 1, [&]() {
+		do_not_optimize(w.load_state(json));
+	}, config));
+
+	std::remove(ckpt.c_str());
+	std::remove(json.c_str());
+}
+
+
+/** @brief Multi-thread scaling of bulk uniform generation with one pool stream per thread. */
+template <class PRNGType>
+void bench_scaling(const std::string& name, size_t max_threads, BenchConfig config, std::vector<BenchResult>& results)
+{
+	for(size_t n = 1; n <= max_threads; n *= 2)
+	{
+		PRNGPool<PRNGType> pool(12345, n);
+		for(size_t t = 0; t < n; t++)
+			{ pool.get(t); } //Seed outside the timed region
+
+		std::vector<std::vector<double>> buffers(n, std::vector<double>(Draws));
+		results.push_back(bench_threads(name + " uni_fill() x" + std::to_string(n) + " threads", n, Draws, [&](size_t t) {
+			pool.get(t).uni_fill(std::span<double>(buffers[t]));
+			do_not_optimize(buffers[t].data());
+		}, config));
+	}
+}
+
+
+/** @brief Multi-thread scaling of `parallel_fill()` - one stream split over the threads. */
+template <class PRNGType>
+void bench_parallel_fill(const std::string& name, size_t max_threads, BenchConfig config, std::vector<BenchResult>& results)
+{
+	constexpr size_t Length = size_t(1) << 24;
+	PRNGWrapper<PRNGType> w;
+	w.new_master_seed(12345);
+	std::vector<double> buffer(Length);
+
+	for(size_t n = 1; n <= max_threads; n *= 2)
+	{
+		results.push_back(bench_run(name + " parallel_fill() x" + std::to_string(n) + " threads", Length, [&]() {
+			w.parallel_fill(std::span<double>(buffer), n);
+			do_not_optimize(buffer.data());
+		}, config));
+	}
+}
+
+
+/** @brief Consumer-side cost of `AsyncPRNG` - single and batch pops, with the underruns of the run. */
+template <class PRNGType>
+void bench_async(const std::string& name, BenchConfig config, std::vector<BenchResult>& results)
+{
+	constexpr size_t Batch = 256;
+	AsyncPRNG<PRNGType> async(12345);
+	std::vector<double> buffer(Batch);
+
+	results.push_back(bench_run(name + " async pop_uni()", Draws, [&]() {
+		double x = 0;
+		for(size_t i = 0; i < Draws; i++)
+		{
+			async.pop_uni(x);
+			do_not_optimize(x);
+		}
+	}, config));
+	results.push_back(bench_run(name + " async pop_uni_n()", Draws, [&]() {
+		for(size_t i = 0; i < Draws; i += Batch)
+		{
+			async.pop_uni_n(std::span<double>(buffer));
+			do_not_optimize(buffer.data());
+		}
+	}, config));
+
+	const AsyncUnderruns underruns = async.uni_underruns();
+	std::cout << name << " async: " << underruns.Events << " underruns, " << underruns.Missing << " values missing\n";
+}
+
+
+int main(int argc, char** argv)
+{
+	BenchConfig config;
+	if(argc > 1)
+		{ config.Repetitions = std::strtoul(argv[1], nullptr, 10); }
+
+	size_t max_threads = std::thread::hardware_concurrency();
+	if(argc > 2)
+		{ max_threads = std::strtoul(argv[2], nullptr, 10); }
+	if(max_threads == 0)
+		{ max_threads = 1; }
+
+	std::vector<BenchResult> results;
+
+	bench_wrapper<std::mt19937, std::normal_distribution<double>>("mt19937", config, results);
+	bench_wrapper<std::mt19937, ziggurat_normal_distribution<double>>("mt19937/ziggurat", config, results);
+	bench_wrapper<std::mt19937_64, std::normal_distribution<double>>("mt19937_64", config, results);
+	bench_wrapper<std::mt19937_64, ziggurat_normal_distribution<double>>("mt19937_64/ziggurat", config, results);
+	bench_wrapper<sfmt19937, std::normal_distribution<double>>("sfmt19937", config, results);
+	bench_wrapper<sfmt19937, ziggurat_normal_distribution<double>>("sfmt19937/ziggurat", config, results);
+	bench_wrapper<philox4x32, std::normal_distribution<double>>("philox4x32", config, results);
+	bench_wrapper<philox4x32, ziggurat_normal_distribution<double>>("philox4x32/ziggurat", config, results);
+	bench_wrapper<threefry4x32, std::normal_distribution<double>>("threefry4x32", config, results);
+	bench_wrapper<threefry4x32, ziggurat_normal_distribution<double>>("threefry4x32/ziggurat", config, results);
+	bench_wrapper<xoshiro256starstar, std::normal_distribution<double>>("xoshiro256**", config, results);
+	bench_wrapper<xoshiro256starstar, ziggurat_normal_distribution<double>>("xoshiro256**/ziggurat", config, results);
+	bench_wrapper<xoshiro256plus, ziggurat_normal_distribution<double>>("xoshiro256+/ziggurat", config, results);
+	bench_wrapper<pcg64, std::normal_distribution<double>>("pcg64", config, results);
+	bench_wrapper<pcg64, ziggurat_normal_distribution<double>>("pcg64/ziggurat", config, results);
+	bench_wrapper<wyrand, ziggurat_normal_distribution<double>>("wyrand/ziggurat", config, results);
+
+	bench_scaling<std::mt19937>("mt19937", max_threads, config, results);
+	bench_scaling<philox4x32>("philox4x32", max_threads, config, results);
+	bench_scaling<xoshiro256starstar>("xoshiro256**", max_threads, config, results);
+
+	bench_parallel_fill<std::mt19937>("mt19937", max_threads, config, results);
+	bench_parallel_fill<philox4x32>("philox4x32", max_threads, config, results);
+	bench_parallel_fill<xoshiro256starstar>("xoshiro256**", max_threads, config, results);
+
+	bench_async<std::mt19937_64>("mt19937_64", config, results);
+	bench_async<xoshiro256starstar>("xoshiro256**", config, results);
+
+	std::cout << "Repetitions: " << config.Repetitions << ", warm-up runs: " << config.Warmup << "\n\n";
+	BenchResult::header(std::cout);
+	for(const auto& r : results)
+		{ std::cout << r; }
+}
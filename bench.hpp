@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <ostream>
+#include <iomanip>
+
+
+/** @brief Keeps `value` alive so that the compiler cannot remove the computation that
+ * produced it (the `DoNotOptimize` idiom). */
+template <typename Type>
+inline void do_not_optimize(const Type& value) __attribute__((always_inline));
+
+template <typename Type>
+inline void do_not_optimize(const Type& value)
+{
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/** @brief Forces all pending writes to memory (buffers filled by bulk calls count as used). */
+inline void clobber_memory() __attribute__((always_inline));
+
+inline void clobber_memory()
+{
+	asm volatile("" : : : "memory");
+}
+
+
+/** @brief Settings of one benchmark. */
+struct BenchConfig
+{
+	size_t Warmup = 3; //!< Untimed runs before the measurement (caches, branch predictors, page faults)
+	size_t Repetitions = 21; //!< Timed runs, the statistics are taken over these
+};
+
+
+/** @brief Result of one benchmark. All the times are in nanoseconds per item. */
+struct BenchResult
+{
+	std::string Name; //!< Benchmark name
+	size_t Items = 0; //!< Items (draws, seedings, ...) per repetition
+	std::vector<double> Samples; //!< ns/item of every repetition, sorted
+
+	double min() const { return Samples.empty() ? 0.0 : Samples.front(); }
+	double max() const { return Samples.empty() ? 0.0 : Samples.back(); }
+	double median() const { return percentile(50.0); }
+
+	/** @brief Returns the `p`-th percentile (nearest rank) of the repetitions. */
+	double percentile(double p) const {
+		if(Samples.empty())
+			{ return 0.0; }
+		size_t rank = static_cast<size_t>(p / 100.0 * double(Samples.size() - 1) + 0.5);
+		return Samples[std::min(rank, Samples.size() - 1)];
+		}
+
+	/** @brief Prints the column names matching `operator<<`. */
+	static void header(std::ostream& os) {
+		os << std::left << std::setw(56) << "benchmark" << std::right
+		   << std::setw(16) << "items"
+		   << std::setw(16) << "median"
+		   << std::setw(16) << "p05"
+		   << std::setw(16) << "p95"
+		   << std::setw(16) << "min"
+		   << std::setw(16) << "max" << "  [ns/item]\n";
+		}
+
+	friend std::ostream& operator<<(std::ostream& os, const BenchResult& r) {
+		const auto flags = os.flags();
+		os << std::left << std::setw(56) << r.Name << std::right << std::fixed << std::setprecision(3)
+		   << std::setw(16) << r.Items
+		   << std::setw(16) << r.median()
+		   << std::setw(16) << r.percentile(5.0)
+		   << std::setw(16) << r.percentile(95.0)
+		   << std::setw(16) << r.min()
+		   << std::setw(16) << r.max() << '\n';
+		os.flags(flags);
+		return os;
+		}
+};
+
+
+/** @brief Times `fn()`, which must process `items` items per call.
+ * @param name Benchmark name.
+ * @param items Items processed by one call of `fn`.
+ * @param fn Benchmarked callable, results must be passed to `do_not_optimize()`.
+ * @param config Warm-up runs and repetitions. */
+template <typename Fn>
+BenchResult bench_run(const std::string& name, size_t items, Fn&& fn, BenchConfig config = {})
+{
+	using clock = std::chrono::steady_clock;
+
+	BenchResult result;
+	result.Name = name;
+	result.Items = items;
+	result.Samples.reserve(config.Repetitions);
+
+	for(size_t i = 0; i < config.Warmup; i++)
+		{ fn(); }
+	clobber_memory();
+
+	for(size_t i = 0; i < config.Repetitions; i++)
+	{
+		const auto start = clock::now();
+		fn();
+		clobber_memory();
+		const auto end = clock::now();
+		const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+		result.Samples.push_back(ns / double(items == 0 ? 1 : items));
+	}
+
+	std::sort(result.Samples.begin(), result.Samples.end());
+	return result;
+}
+
+
+/** @brief Times `fn(thread_index)` on `n_threads` threads started together. Every call must
+ * process `items_per_thread` items. The reported time is wall time per item over all the
+ * threads, so ideal scaling divides it by the number of threads.
+ * \attention Thread creation is outside the timed region; the threads spin on a start flag. */
+template <typename Fn>
+BenchResult bench_threads(const std::string& name, size_t n_threads, size_t items_per_thread, Fn&& fn, BenchConfig config = {})
+{
+	using clock = std::chrono::steady_clock;
+
+	BenchResult result;
+	result.Name = name;
+	result.Items = items_per_thread * n_threads;
+	result.Samples.reserve(config.Repetitions);
+
+	for(size_t rep = 0; rep < config.Warmup + config.Repetitions; rep++)
+	{
+		std::atomic<size_t> ready{0};
+		std::atomic<bool> go{false};
+		std::vector<std::thread> threads;
+		threads.reserve(n_threads);
+		for(size_t t = 0; t < n_threads; t++)
+		{
+			threads.emplace_back([&, t]() {
+				ready.fetch_add(1, std::memory_order_acq_rel);
+				while(!go.load(std::memory_order_acquire))
+					{ std::this_thread::yield(); }
+				fn(t);
+			});
+		}
+		while(ready.load(std::memory_order_acquire) != n_threads)
+			{ std::this_thread::yield(); }
+
+		const auto start = clock::now();
+		go.store(true, std::memory_order_release);
+		for(auto& thread : threads)
+			{ thread.join(); }
+		const auto end = clock::now();
+
+		if(rep >= config.Warmup)
+		{
+			const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+			result.Samples.push_back(ns / double(result.Items == 0 ? 1 : result.Items));
+		}
+	}
+
+	std::sort(result.Samples.begin(), result.Samples.end());
+	return result;
+}
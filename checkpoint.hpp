@@ -0,0 +1,391 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <span>
+#include <fstream>
+#include <type_traits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <functional>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+/** @brief Binary checkpoint format for many generator states in one file.
+ *
+ * Layout (native byte order, identified by `EndianTag`):
+ *
+ *     CheckpointHeader                  - magic, version, endian tag, layout tag, record count
+ *     std::uint64_t offsets[count + 1]  - byte offset of every record from the file start, last = file size
+ *     records                           - every record starts on an 8-byte boundary
+ *
+ * Records are raw object bytes (`checkpoint_put()`), hence restoring costs a `memcpy` per
+ * object. The bytes are only meaningful for the same standard library and object layout,
+ * which is checked through the layout tag; the json state files remain the portable format. */
+struct CheckpointHeader
+{
+	static constexpr char MagicString[8] = {'P', 'R', 'N', 'G', 'W', 'C', 'K', 'P'};
+	static constexpr std::uint32_t CurrentVersion = 1;
+	static constexpr std::uint32_t NativeEndianTag = 0x01020304U;
+
+	char Magic[8]; //!< "PRNGWCKP"
+	std::uint32_t Version; //!< Format version
+	std::uint32_t EndianTag; //!< `NativeEndianTag` written in the byte order of the writer
+	std::uint64_t LayoutTag; //!< Hash of the record layout (object sizes and standard library)
+	std::uint64_t Count; //!< Number of records
+};
+
+static_assert(sizeof(CheckpointHeader) == 32, "CheckpointHeader must not contain padding.");
+
+
+/** @brief Appends the bytes of `obj` to the buffer. Objects with a `serialize(buffer)` member
+ * serialize themselves, every other object must be trivially copyable. */
+template <typename Type>
+void checkpoint_put(std::vector<std::byte>& buffer, const Type& obj)
+{
+	if constexpr (requires { obj.serialize(buffer); })
+		{ obj.serialize(buffer); }
+	else
+	{
+		static_assert(std::is_trivially_copyable_v<Type>, "checkpoint_put() requires a trivially copyable type or a serialize() member.");
+		const size_t offset = buffer.size();
+		buffer.resize(offset + sizeof(Type));
+		std::memcpy(buffer.data() + offset, &obj, sizeof(Type));
+	}
+}
+
+/** @brief Reads `obj` from the record at `offset` and advances the offset. Returns false if
+ * the record is too short. Objects with a `deserialize(record, offset)` member read themselves. */
+template <typename Type>
+bool checkpoint_get(std::span<const std::byte> record, size_t& offset, Type& obj)
+{
+	if constexpr (requires { { obj.deserialize(record, offset) } -> std::convertible_to<bool>; })
+		{ return obj.deserialize(record, offset); }
+	else
+	{
+		static_assert(std::is_trivially_copyable_v<Type>, "checkpoint_get() requires a trivially copyable type or a deserialize() member.");
+		if(record.size() < offset + sizeof(Type))
+			{ return false; }
+		std::memcpy(&obj, record.data() + offset, sizeof(Type));
+		offset += sizeof(Type);
+		return true;
+	}
+}
+
+/** @brief FNV-1a hash step used to build layout tags. */
+constexpr std::uint64_t checkpoint_tag(std::uint64_t tag, std::uint64_t value)
+{
+	for(int i = 0; i < 8; i++)
+	{
+		tag ^= (value >> (8 * i)) & 0xFF;
+		tag *= 0x100000001B3ULL;
+	}
+	return tag;
+}
+
+/** @brief Layout tag seed that identifies the standard library the records were written with. */
+constexpr std::uint64_t checkpoint_library_tag()
+{
+	std::uint64_t tag = 0xCBF29CE484222325ULL;
+#if defined(__GLIBCXX__)
+	tag = checkpoint_tag(tag, 1);
+	tag = checkpoint_tag(tag, __GLIBCXX__);
+#elif defined(_LIBCPP_VERSION)
+	tag = checkpoint_tag(tag, 2);
+	tag = checkpoint_tag(tag, _LIBCPP_VERSION);
+#elif defined(_MSC_VER)
+	tag = checkpoint_tag(tag, 3);
+	tag = checkpoint_tag(tag, _MSC_VER);
+#endif
+	tag = checkpoint_tag(tag, sizeof(void*));
+	return tag;
+}
+
+
+/** @brief Writes records into a binary checkpoint file.
+ * \return false if the file could not be written. */
+inline bool checkpoint_write(const std::string& filename, std::uint64_t layout_tag, std::span<const std::vector<std::byte>> records)
+{
+	CheckpointHeader header;
+	std::memcpy(header.Magic, CheckpointHeader::MagicString, sizeof(header.Magic));
+	header.Version = CheckpointHeader::CurrentVersion;
+	header.EndianTag = CheckpointHeader::NativeEndianTag;
+	header.LayoutTag = layout_tag;
+	header.Count = records.size();
+
+	std::vector<std::uint64_t> offsets(records.size() + 1);
+	std::uint64_t pos = sizeof(CheckpointHeader) + offsets.size() * sizeof(std::uint64_t);
+	for(size_t i = 0; i < records.size(); i++)
+	{
+		offsets[i] = pos;
+		pos += (records[i].size() + 7) & ~std::uint64_t(7);
+	}
+	offsets[records.size()] = pos;
+
+	std::ofstream fout(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	if(!fout.is_open())
+		{ return false; }
+
+	static const char padding[8] = {};
+	fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	fout.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(std::uint64_t));
+	for(const auto& record : records)
+	{
+		fout.write(reinterpret_cast<const char*>(record.data()), record.size());
+		fout.write(padding, ((record.size() + 7) & ~size_t(7)) - record.size());
+	}
+
+	fout.close();
+	return !fout.fail();
+}
+
+
+/** @brief Writes records into a binary checkpoint file durably. The file is written to
+ * `filename.tmp`, flushed with `fsync` and renamed over `filename`, so a crash leaves either
+ * the old or the new checkpoint, never a truncated one.
+ * \return false if the file could not be written. */
+inline bool checkpoint_commit(const std::string& filename, std::uint64_t layout_tag, std::span<const std::vector<std::byte>> records)
+{
+	const std::string tmp = filename + ".tmp";
+	if(!checkpoint_write(tmp, layout_tag, records))
+		{ return false; }
+
+	int fd = ::open(tmp.c_str(), O_RDONLY | O_CLOEXEC);
+	if(fd == -1)
+		{ return false; }
+	const bool synced = ::fsync(fd) == 0;
+	::close(fd);
+
+	if(!synced || std::rename(tmp.c_str(), filename.c_str()) != 0)
+	{
+		std::remove(tmp.c_str());
+		return false;
+	}
+
+	//Persist the rename itself
+	const size_t slash = filename.find_last_of('/');
+	const std::string dir = (slash == std::string::npos) ? std::string(".") : filename.substr(0, slash + 1);
+	int dir_fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if(dir_fd != -1)
+	{
+		::fsync(dir_fd);
+		::close(dir_fd);
+	}
+	return true;
+}
+
+
+/** @brief Background thread that writes checkpoints. The caller hands over the record
+ * bytes (a snapshot taken in memory, see `PRNGWrapper::snapshot()`), and the writer
+ * serializes, `fsync`s and renames the file (`checkpoint_commit()`) while the caller continues.
+ * Jobs are written in submission order; the destructor writes all pending jobs before it returns. */
+class CheckpointWriter
+{
+public:
+
+	using callback_type = std::function<void(bool)>; //!< Called on the writer thread with the result
+
+private:
+
+	struct Job
+	{
+		std::string Filename;
+		std::uint64_t LayoutTag;
+		std::vector<std::vector<std::byte>> Records;
+		std::promise<bool> Done;
+		callback_type Callback;
+	};
+
+	std::mutex Mutex; //!< Guards `Jobs` and `Stop`
+	std::condition_variable Ready; //!< Signalled on a new job or on shutdown
+	std::condition_variable Drained; //!< Signalled when the queue is empty and the writer is idle
+	std::deque<Job> Jobs; //!< Pending jobs
+	bool Busy = false; //!< A job is being written
+	bool Stop = false; //!< Set by the destructor
+	std::thread Worker; //!< Writer thread
+
+public:
+
+	//0
+	/** @brief Constructor -> Starts the writer thread. */
+	CheckpointWriter(): Worker([this]() { this->run(); }) {}
+
+	/** @brief Destructor -> Writes the pending jobs and joins the writer thread. */
+	~CheckpointWriter() {
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			Stop = true;
+		}
+		Ready.notify_one();
+		Worker.join();
+		}
+
+	CheckpointWriter(const CheckpointWriter&) = delete;
+	CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+	//1
+	/** @brief Queues a checkpoint and returns immediately. The records are moved into the job.
+	 * @param callback Optional, called on the writer thread once the file is written (or failed).
+	 * \return Future that becomes `true` once the file is durably on disk. */
+	std::future<bool> submit(const std::string& filename, std::uint64_t layout_tag,
+	                         std::vector<std::vector<std::byte>> records, callback_type callback = nullptr) {
+		Job job{filename, layout_tag, std::move(records), std::promise<bool>(), std::move(callback)};
+		std::future<bool> result = job.Done.get_future();
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			Jobs.push_back(std::move(job));
+		}
+		Ready.notify_one();
+		return result;
+		}
+
+	//2
+	/** @brief Blocks until every submitted checkpoint has been written. */
+	void wait() {
+		std::unique_lock<std::mutex> lock(Mutex);
+		Drained.wait(lock, [this]() { return Jobs.empty() && !Busy; });
+		}
+
+	//3
+	/** @brief Returns the number of checkpoints that are queued or being written. */
+	size_t pending() {
+		std::lock_guard<std::mutex> lock(Mutex);
+		return Jobs.size() + (Busy ? 1 : 0);
+		}
+
+private:
+//Helper Functions
+
+	void run() {
+		std::unique_lock<std::mutex> lock(Mutex);
+		while(true)
+		{
+			Ready.wait(lock, [this]() { return Stop || !Jobs.empty(); });
+			if(Jobs.empty()) //Stop and nothing left
+				{ return; }
+
+			Job job = std::move(Jobs.front());
+			Jobs.pop_front();
+			Busy = true;
+			lock.unlock();
+
+			const bool status = checkpoint_commit(job.Filename, job.LayoutTag, job.Records);
+			if(job.Callback)
+				{ job.Callback(status); }
+			job.Done.set_value(status);
+
+			lock.lock();
+			Busy = false;
+			if(Jobs.empty())
+				{ Drained.notify_all(); }
+		}
+		}
+};
+
+
+/** @brief Read-only, memory-mapped view of a binary checkpoint file. Records are read
+ * directly from the mapping without copying the file. */
+class CheckpointFile
+{
+	const std::byte* Data; //!< Mapped file
+	size_t Size; //!< Size of the mapping
+	bool Valid; //!< Header and offsets table are consistent
+
+public:
+
+	//0
+	/** @brief Constructor -> Maps the file and validates the header and the offsets table.
+	 * @param filename Checkpoint file.
+	 * @param layout_tag Expected layout tag of the records. */
+	CheckpointFile(const std::string& filename, std::uint64_t layout_tag): Data(nullptr), Size(0), Valid(false) {
+		int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+		if(fd == -1)
+			{ return; }
+
+		struct stat st;
+		if(::fstat(fd, &st) == 0 && st.st_size >= off_t(sizeof(CheckpointHeader)))
+		{
+			void* map = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+			if(map != MAP_FAILED)
+			{
+				Data = static_cast<const std::byte*>(map);
+				Size = size_t(st.st_size);
+			}
+		}
+		::close(fd); //The mapping stays valid
+
+		Valid = Data != nullptr && validate(layout_tag);
+		}
+
+	/** @brief Destructor -> Unmaps the file. */
+	~CheckpointFile() {
+		if(Data != nullptr)
+			{ ::munmap(const_cast<std::byte*>(Data), Size); }
+		}
+
+	CheckpointFile(const CheckpointFile&) = delete;
+	CheckpointFile& operator=(const CheckpointFile&) = delete;
+
+	//1
+	/** @brief Returns true if the file was mapped and matches the expected format and layout. */
+	bool is_valid() const { return Valid; }
+
+	//2
+	/** @brief Returns the number of records. */
+	size_t count() const {
+		return Valid ? size_t(header().Count) : 0;
+		}
+
+	//3
+	/** @brief Returns the bytes of record `index` (empty if out of range). */
+	std::span<const std::byte> record(size_t index) const {
+		if(index >= count())
+			{ return {}; }
+		const std::uint64_t* offsets = offsets_table();
+		return {Data + offsets[index], size_t(offsets[index + 1] - offsets[index])};
+		}
+
+private:
+//Helper Functions
+
+	const CheckpointHeader& header() const {
+		return *reinterpret_cast<const CheckpointHeader*>(Data);
+		}
+
+	const std::uint64_t* offsets_table() const {
+		return reinterpret_cast<const std::uint64_t*>(Data + sizeof(CheckpointHeader));
+		}
+
+	/** @brief Checks the magic, version, byte order, layout and that all records are inside the file. */
+	bool validate(std::uint64_t layout_tag) const {
+		const CheckpointHeader& h = header();
+		if(std::memcmp(h.Magic, CheckpointHeader::MagicString, sizeof(h.Magic)) != 0 ||
+		   h.Version != CheckpointHeader::CurrentVersion ||
+		   h.EndianTag != CheckpointHeader::NativeEndianTag ||
+		   h.LayoutTag != layout_tag)
+			{ return false; }
+
+		const size_t table_end = sizeof(CheckpointHeader) + (size_t(h.Count) + 1) * sizeof(std::uint64_t);
+		if(h.Count > Size || table_end > Size)
+			{ return false; }
+
+		const std::uint64_t* offsets = offsets_table();
+		for(size_t i = 0; i < h.Count; i++)
+		{
+			if(offsets[i] < table_end || offsets[i] > offsets[i + 1])
+				{ return false; }
+		}
+		return offsets[h.Count] <= Size;
+		}
+};
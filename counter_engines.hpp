@@ -0,0 +1,381 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <span>
+#include <limits>
+#include <istream>
+#include <ostream>
+
+//Reference - "Parallel Random Numbers: As Easy as 1, 2, 3", J. K. Salmon, M. A. Moraes, R. O. Dror, D. E. Shaw in SC '11 Proceedings, 2011
+
+
+/** @brief Philox4x32-10 bijection. Maps a 128-bit counter and a 64-bit key to 128 random bits.
+ * `apply()` evaluates `Lanes` independent counters at once; the lanes are kept in separate
+ * arrays so that the rounds vectorize. */
+struct Philox4x32_10
+{
+	static constexpr size_t key_words = 2; //!< Number of 32-bit words in the key
+	static constexpr size_t rounds = 10;
+
+	static constexpr std::uint32_t M0 = 0xD2511F53U;
+	static constexpr std::uint32_t M1 = 0xCD9E8D57U;
+	static constexpr std::uint32_t W0 = 0x9E3779B9U;
+	static constexpr std::uint32_t W1 = 0xBB67AE85U;
+
+	template <size_t Lanes>
+	__attribute__((always_inline)) static inline void apply(std::uint32_t (&x)[4][Lanes], const std::array<std::uint32_t, key_words>& key) {
+		std::uint32_t k0 = key[0];
+		std::uint32_t k1 = key[1];
+
+		for(size_t r = 0; r < rounds; r++)
+		{
+			for(size_t l = 0; l < Lanes; l++)
+			{
+				const std::uint64_t p0 = std::uint64_t(M0) * x[0][l];
+				const std::uint64_t p1 = std::uint64_t(M1) * x[2][l];
+				const std::uint32_t y0 = std::uint32_t(p1 >> 32) ^ x[1][l] ^ k0;
+				const std::uint32_t y2 = std::uint32_t(p0 >> 32) ^ x[3][l] ^ k1;
+				x[0][l] = y0;
+				x[1][l] = std::uint32_t(p1);
+				x[2][l] = y2;
+				x[3][l] = std::uint32_t(p0);
+			}
+			k0 += W0;
+			k1 += W1;
+		}
+		}
+};
+
+
+/** @brief Threefry4x32-20 bijection. Maps a 128-bit counter and a 128-bit key to 128 random bits. */
+struct Threefry4x32_20
+{
+	static constexpr size_t key_words = 4; //!< Number of 32-bit words in the key
+	static constexpr size_t rounds = 20;
+
+	static constexpr std::uint32_t Parity = 0x1BD11BDAU;
+	static constexpr unsigned Rot[8][2] = {{10, 26}, {11, 21}, {13, 27}, {23, 5}, {6, 20}, {17, 11}, {25, 10}, {18, 20}};
+
+	static constexpr std::uint32_t rotl(std::uint32_t v, unsigned s) { return (v << s) | (v >> (32 - s)); }
+
+	template <size_t Lanes>
+	__attribute__((always_inline)) static inline void apply(std::uint32_t (&x)[4][Lanes], const std::array<std::uint32_t, key_words>& key) {
+		const std::uint32_t ks[5] = {key[0], key[1], key[2], key[3], Parity ^ key[0] ^ key[1] ^ key[2] ^ key[3]};
+
+		for(size_t i = 0; i < 4; i++)
+			for(size_t l = 0; l < Lanes; l++)
+				{ x[i][l] += ks[i]; }
+
+		for(size_t r = 0; r < rounds; r++)
+		{
+			const unsigned* rot = Rot[r % 8];
+			for(size_t l = 0; l < Lanes; l++)
+			{
+				if(r % 2 == 0)
+				{
+					x[0][l] += x[1][l]; x[1][l] = rotl(x[1][l], rot[0]); x[1][l] ^= x[0][l];
+					x[2][l] += x[3][l]; x[3][l] = rotl(x[3][l], rot[1]); x[3][l] ^= x[2][l];
+				}
+				else
+				{
+					x[0][l] += x[3][l]; x[3][l] = rotl(x[3][l], rot[0]); x[3][l] ^= x[0][l];
+					x[2][l] += x[1][l]; x[1][l] = rotl(x[1][l], rot[1]); x[1][l] ^= x[2][l];
+				}
+			}
+
+			if(r % 4 == 3) //Key injection
+			{
+				const size_t s = (r + 1) / 4;
+				for(size_t i = 0; i < 4; i++)
+					for(size_t l = 0; l < Lanes; l++)
+						{ x[i][l] += ks[(s + i) % 5]; }
+				for(size_t l = 0; l < Lanes; l++)
+					{ x[3][l] += static_cast<std::uint32_t>(s); }
+			}
+		}
+		}
+};
+
+
+/** @brief Counter-based engine that satisfies the `UniformRandomBitGenerator` concept and
+ * can be passed as the `PRNGType` of `PRNGWrapper`. The state is a key and a 128-bit
+ * counter - output `n` of the stream is word `n % 4` of `Bijection(n / 4, key)`, hence
+ * `discard()` and `jump()` are O(1) and no warm-up is needed. Independent streams are
+ * obtained with different keys or by jumping to disjoint counter ranges.
+ * \attention Seeding from a seed sequence fills the key, the counter is reset to zero. */
+template <class Bijection>
+class counter_engine
+{
+public:
+
+	using result_type = std::uint32_t; //!< Output type of the engine
+	using key_type = std::array<std::uint32_t, Bijection::key_words>; //!< Key of the stream
+	using counter_type = std::array<std::uint32_t, 4>; //!< 128-bit counter, least significant word first
+
+	static constexpr size_t word_size = 32; //!< Number of bits in every output
+	static constexpr size_t state_size = Bijection::key_words; //!< Number of seed words (key words)
+	static constexpr result_type default_seed = 20111115u; //!< Seed used by the default constructor
+
+private:
+
+	static constexpr size_t Lanes = 8; //!< Number of blocks evaluated together in `generate()`
+
+	key_type Key; //!< Key of the stream
+	counter_type Counter = {}; //!< Counter of the current block
+	counter_type Block; //!< Output of the current block
+	unsigned Index = 0; //!< Index of the next output within the block
+
+public:
+
+	//0
+	/** @brief Constructor -> Seeds the engine with `default_seed`. */
+	counter_engine() { seed(default_seed); }
+
+	/** @brief Constructor -> Seeds the engine with a single seed. */
+	explicit counter_engine(result_type x_seed) { seed(x_seed); }
+
+	/** @brief Constructor -> Sets the key and the counter. */
+	counter_engine(const key_type& key, const counter_type& counter = {}) { set_key(key); set_counter(counter); }
+
+	/** @brief Constructor -> Seeds the engine with a seed sequence. */
+	template <class SeedSeq, typename = decltype(std::declval<SeedSeq&>().generate(std::declval<std::uint32_t*>(), std::declval<std::uint32_t*>()))>
+	explicit counter_engine(SeedSeq& seq) { seed(seq); }
+
+	//1
+	/** @brief Smallest value returned by the engine. */
+	static constexpr result_type min() { return 0; }
+
+	//2
+	/** @brief Largest value returned by the engine. */
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+	//3
+	/** @brief Use a single seed as the first key word. The counter is reset to zero. */
+	void seed(result_type x_seed = default_seed) {
+		key_type key = {};
+		key[0] = x_seed;
+		set_key(key);
+		set_counter({});
+		}
+
+	//4
+	/** @brief Fill the key from a seed sequence. The counter is reset to zero. */
+	template <class SeedSeq>
+	auto seed(SeedSeq& seq) -> decltype(seq.generate(std::declval<std::uint32_t*>(), std::declval<std::uint32_t*>()), void()) {
+		key_type key;
+		seq.generate(key.begin(), key.end());
+		set_key(key);
+		set_counter({});
+		}
+
+	//5
+	/** @brief Returns the next 32-bit random number. */
+	result_type inline operator()() __attribute__((always_inline)) {
+		if(Index >= 4)
+		{
+			increment(Counter, 1);
+			refresh();
+			Index = 0;
+		}
+		return Block[Index++];
+		}
+
+	//6
+	/** @brief Advances the engine by `z` outputs in constant time. */
+	void discard(unsigned long long z) {
+		const unsigned long long pos = Index + (z % 4);
+		increment(Counter, z / 4 + pos / 4);
+		Index = static_cast<unsigned>(pos % 4);
+		refresh();
+		}
+
+	//7
+	/** @brief Advances the engine by `distance * 2^shift` outputs in constant time.
+	 * Distances beyond 2^130 wrap around the counter. */
+	void jump(std::uint64_t distance, unsigned shift = 0) {
+		if(shift < 2)
+		{
+			discard(distance);
+			if(shift == 1)
+				{ discard(distance); }
+			return;
+		}
+		add_shifted(Counter, distance, shift - 2);
+		refresh();
+		}
+
+	//8
+	/** @brief Batched 4-lane output path. Fills the span with the same numbers that repeated
+	 * calls of `operator()` would return. Whole blocks are evaluated `Lanes` at a time. */
+	void generate(std::span<result_type> out) {
+		size_t n = 0;
+		const size_t size = out.size();
+
+		//Finish the current block
+		while(Index < 4 && n < size)
+			{ out[n++] = Block[Index++]; }
+
+		//Full blocks, Lanes at a time
+		while(size - n >= 4 * Lanes)
+		{
+			std::uint32_t x[4][Lanes];
+			counter_type ctr = Counter;
+			for(size_t l = 0; l < Lanes; l++)
+			{
+				increment(ctr, 1);
+				for(size_t i = 0; i < 4; i++)
+					{ x[i][l] = ctr[i]; }
+			}
+
+			Bijection::apply(x, Key);
+
+			for(size_t l = 0; l < Lanes; l++)
+				for(size_t i = 0; i < 4; i++)
+					{ out[n++] = x[i][l]; }
+
+			Counter = ctr;
+		}
+
+		//Tail
+		while(n < size)
+			{ out[n++] = (*this)(); }
+		}
+
+	//9
+	/** @brief Returns the 128 random bits of block `counter` without changing the engine. */
+	counter_type block(const counter_type& counter) const {
+		std::uint32_t x[4][1] = {{counter[0]}, {counter[1]}, {counter[2]}, {counter[3]}};
+		Bijection::apply(x, Key);
+		return {x[0][0], x[1][0], x[2][0], x[3][0]};
+		}
+
+	//10
+	/** @brief Sets the key of the stream. The position within the stream is kept. */
+	void set_key(const key_type& key) {
+		Key = key;
+		refresh();
+		}
+
+	//11
+	/** @brief Moves the engine to the start of block `counter`. */
+	void set_counter(const counter_type& counter) {
+		Counter = counter;
+		Index = 0;
+		refresh();
+		}
+
+	//12
+	/** @brief Moves the engine to output `position` of the stream. */
+	void seek(unsigned long long position) {
+		set_counter({});
+		discard(position);
+		}
+
+	key_type key() const { return Key; }
+	counter_type counter() const { return Counter; }
+
+	/** @brief Engines compare equal if their future streams are equal. The end of a block and
+	 * the start of the next one are the same position. */
+	friend bool operator==(const counter_engine& lhs, const counter_engine& rhs) {
+		counter_type lc = lhs.Counter, rc = rhs.Counter;
+		if(lhs.Index >= 4)
+			{ increment(lc, 1); }
+		if(rhs.Index >= 4)
+			{ increment(rc, 1); }
+		return lhs.Key == rhs.Key && lc == rc && lhs.Index % 4 == rhs.Index % 4;
+		}
+
+	/** @brief Writes the engine state (key words, counter words and the index) as text. */
+	template <class CharT, class Traits>
+	friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const counter_engine& engine) {
+		const auto flags = os.flags();
+		const CharT space = os.widen(' ');
+		os.flags(std::ios_base::dec | std::ios_base::left);
+		os.fill(space);
+
+		for(auto k : engine.Key)
+			{ os << k << space; }
+		for(auto c : engine.Counter)
+			{ os << c << space; }
+		os << engine.Index;
+
+		os.flags(flags);
+		return os;
+		}
+
+	/** @brief Reads the engine state written by `operator<<`. */
+	template <class CharT, class Traits>
+	friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, counter_engine& engine) {
+		const auto flags = is.flags();
+		is.flags(std::ios_base::dec | std::ios_base::skipws);
+
+		key_type key;
+		counter_type counter;
+		unsigned index = 0;
+		for(auto& k : key)
+			{ is >> k; }
+		for(auto& c : counter)
+			{ is >> c; }
+		is >> index;
+
+		if(!is.fail() && index <= 4)
+		{
+			engine.Key = key;
+			engine.Counter = counter;
+			engine.Index = index;
+			engine.refresh();
+		}
+		else
+			{ is.setstate(std::ios_base::failbit); }
+
+		is.flags(flags);
+		return is;
+		}
+
+private:
+//Helper Functions
+
+	/** @brief Recomputes the output of the current block. */
+	void refresh() {
+		Block = block(Counter);
+		}
+
+	/** @brief Adds `delta` to the 128-bit counter. */
+	static void increment(counter_type& ctr, std::uint64_t delta) {
+		std::uint64_t carry = delta;
+		for(size_t i = 0; i < 4 && carry != 0; i++)
+		{
+			const std::uint64_t sum = std::uint64_t(ctr[i]) + (carry & 0xFFFFFFFFU);
+			ctr[i] = static_cast<std::uint32_t>(sum);
+			carry = (carry >> 32) + (sum >> 32);
+		}
+		}
+
+	/** @brief Adds `delta * 2^shift` to the 128-bit counter. */
+	static void add_shifted(counter_type& ctr, std::uint64_t delta, unsigned shift) {
+		if(shift >= 128)
+			{ return; }
+
+		const size_t word = shift / 32;
+		const unsigned bit = shift % 32;
+		//delta << bit spans up to three 32-bit words
+		std::uint64_t carry = 0;
+		const std::uint64_t parts[3] = {
+			(delta << bit) & 0xFFFFFFFFU,
+			(delta >> (32 - bit)) & 0xFFFFFFFFU,
+			(bit == 0) ? 0 : (delta >> (64 - bit))
+		};
+		for(size_t i = word; i < 4; i++)
+		{
+			const size_t p = i - word;
+			std::uint64_t sum = std::uint64_t(ctr[i]) + carry + ((p < 3) ? parts[p] : 0);
+			ctr[i] = static_cast<std::uint32_t>(sum);
+			carry = sum >> 32;
+		}
+		}
+};
+
+using philox4x32 = counter_engine<Philox4x32_10>; //!< Philox4x32-10 engine
+using threefry4x32 = counter_engine<Threefry4x32_20>; //!< Threefry4x32-20 engine
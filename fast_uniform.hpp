@@ -0,0 +1,405 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <bit>
+#include <limits>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+#elif defined(__SSE2__)
+	#include <emmintrin.h>
+#endif
+
+
+/** @brief Division-free conversion of random bits to uniform floating point numbers in [0, 1).
+ * The top 52 (double) or 23 (float) bits of a word become the mantissa of a number in [1, 2),
+ * and subtracting 1 gives [0, 1) on an evenly spaced grid of 2^-52 (2^-23). This is one shift,
+ * one OR and one subtraction per number, compared to the two engine calls, the
+ * int-to-float conversions and the division of `std::generate_canonical`.
+ * The streams differ from `std::uniform_real_distribution`. */
+
+
+/** @brief Converts the top 52 bits of `x` to a double in [0, 1). */
+inline double bits_to_double(std::uint64_t x) __attribute__((always_inline));
+
+inline double bits_to_double(std::uint64_t x)
+{
+	return std::bit_cast<double>((x >> 12) | 0x3FF0000000000000ULL) - 1.0;
+}
+
+/** @brief Converts the top 23 bits of `x` to a float in [0, 1). */
+inline float bits_to_float(std::uint32_t x) __attribute__((always_inline));
+
+inline float bits_to_float(std::uint32_t x)
+{
+	return std::bit_cast<float>((x >> 9) | 0x3F800000U) - 1.0f;
+}
+
+
+/** @brief Bulk `bits_to_double()`, AVX2 or SSE2 when available. `out` must not be larger than `in`. */
+inline void bits_to_double(std::span<const std::uint64_t> in, std::span<double> out)
+{
+	const size_t n = out.size();
+	size_t i = 0;
+
+#if defined(__AVX2__)
+	const __m256i exponent = _mm256_set1_epi64x(0x3FF0000000000000LL);
+	const __m256d one = _mm256_set1_pd(1.0);
+	for(; i + 4 <= n; i += 4)
+	{
+		__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in.data() + i));
+		x = _mm256_or_si256(_mm256_srli_epi64(x, 12), exponent);
+		_mm256_storeu_pd(out.data() + i, _mm256_sub_pd(_mm256_castsi256_pd(x), one));
+	}
+#elif defined(__SSE2__)
+	const __m128i exponent = _mm_set1_epi64x(0x3FF0000000000000LL);
+	const __m128d one = _mm_set1_pd(1.0);
+	for(; i + 2 <= n; i += 2)
+	{
+		__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in.data() + i));
+		x = _mm_or_si128(_mm_srli_epi64(x, 12), exponent);
+		_mm_storeu_pd(out.data() + i, _mm_sub_pd(_mm_castsi128_pd(x), one));
+	}
+#endif
+
+	for(; i < n; i++)
+		{ out[i] = bits_to_double(in[i]); }
+}
+
+/** @brief Bulk `bits_to_float()`, AVX2 or SSE2 when available. `out` must not be larger than `in`. */
+inline void bits_to_float(std::span<const std::uint32_t> in, std::span<float> out)
+{
+	const size_t n = out.size();
+	size_t i = 0;
+
+#if defined(__AVX2__)
+	const __m256i exponent = _mm256_set1_epi32(0x3F800000);
+	const __m256 one = _mm256_set1_ps(1.0f);
+	for(; i + 8 <= n; i += 8)
+	{
+		__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in.data() + i));
+		x = _mm256_or_si256(_mm256_srli_epi32(x, 9), exponent);
+		_mm256_storeu_ps(out.data() + i, _mm256_sub_ps(_mm256_castsi256_ps(x), one));
+	}
+#elif defined(__SSE2__)
+	const __m128i exponent = _mm_set1_epi32(0x3F800000);
+	const __m128 one = _mm_set1_ps(1.0f);
+	for(; i + 4 <= n; i += 4)
+	{
+		__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in.data() + i));
+		x = _mm_or_si128(_mm_srli_epi32(x, 9), exponent);
+		_mm_storeu_ps(out.data() + i, _mm_sub_ps(_mm_castsi128_ps(x), one));
+	}
+#endif
+
+	for(; i < n; i++)
+		{ out[i] = bits_to_float(in[i]); }
+}
+
+
+/** @brief Raw 32/64-bit words from an engine with a full 32-bit or 64-bit output range.
+ * 64-bit words of 32-bit engines are two draws (first draw in the high half); 32-bit words of
+ * 64-bit engines are the low and then the high half of one draw. Bulk reads use the engine's
+ * `generate(span)` when it has one (`sfmt19937`, counter-based engines). */
+template <class Engine>
+struct EngineBits
+{
+	using result_type = typename Engine::result_type;
+
+	static constexpr bool wide = Engine::max() == std::numeric_limits<std::uint64_t>::max();
+
+	static_assert(Engine::min() == 0 && (Engine::max() == std::numeric_limits<std::uint32_t>::max() || wide),
+	              "The fast uniform path requires an engine with a full 32-bit or 64-bit output range.");
+
+	static constexpr size_t Block = 256; //!< Words per bulk step, kept on the stack
+
+	/** @brief One 32-bit word of a 32-bit engine. */
+	static std::uint32_t word32(Engine& engine) __attribute__((always_inline)) {
+		static_assert(!wide, "word32() is only used with 32-bit engines.");
+		return static_cast<std::uint32_t>(engine());
+		}
+
+	/** @brief One 64-bit word. */
+	static std::uint64_t word64(Engine& engine) __attribute__((always_inline)) {
+		if constexpr (wide)
+			{ return static_cast<std::uint64_t>(engine()); }
+		else
+		{
+			const std::uint64_t hi = static_cast<std::uint32_t>(engine());
+			return (hi << 32) | static_cast<std::uint32_t>(engine());
+		}
+		}
+
+	/** @brief Fills `out` with 64-bit words. */
+	static void fill64(Engine& engine, std::span<std::uint64_t> out) {
+		if constexpr (wide)
+		{
+			if constexpr (requires { engine.generate(out); })
+				{ engine.generate(out); }
+			else
+			{
+				for(auto& x : out)
+					{ x = static_cast<std::uint64_t>(engine()); }
+			}
+		}
+		else
+		{
+			std::uint32_t tmp[2 * Block];
+			for(size_t begin = 0; begin < out.size(); begin += Block)
+			{
+				const size_t n = (out.size() - begin < Block) ? out.size() - begin : Block;
+				fill32(engine, std::span<std::uint32_t>(tmp, 2 * n));
+				for(size_t i = 0; i < n; i++)
+					{ out[begin + i] = (std::uint64_t(tmp[2 * i]) << 32) | tmp[2 * i + 1]; }
+			}
+		}
+		}
+
+	/** @brief Fills `out` with 32-bit words. */
+	static void fill32(Engine& engine, std::span<std::uint32_t> out) {
+		if constexpr (!wide)
+		{
+			if constexpr (std::is_same_v<result_type, std::uint32_t> && requires { engine.generate(out); })
+				{ engine.generate(out); }
+			else
+			{
+				for(auto& x : out)
+					{ x = static_cast<std::uint32_t>(engine()); }
+			}
+		}
+		else
+		{
+			std::uint64_t tmp[Block];
+			for(size_t begin = 0; begin < out.size(); begin += 2 * Block)
+			{
+				const size_t n = (out.size() - begin < 2 * Block) ? out.size() - begin : 2 * Block;
+				const size_t words = (n + 1) / 2;
+				fill64(engine, std::span<std::uint64_t>(tmp, words));
+				for(size_t i = 0; i < n; i++)
+					{ out[begin + i] = static_cast<std::uint32_t>(tmp[i / 2] >> (32 * (i % 2))); }
+			}
+		}
+		}
+};
+
+
+/** @brief Uniform double in [0, 1) from 52 random bits - one draw of a 64-bit engine, two of a 32-bit engine. */
+template <class Engine>
+inline double fast_uniform(Engine& engine) __attribute__((always_inline));
+
+template <class Engine>
+inline double fast_uniform(Engine& engine)
+{
+	return bits_to_double(EngineBits<Engine>::word64(engine));
+}
+
+/** @brief Uniform float in [0, 1) from 23 random bits of one draw. */
+template <class Engine>
+inline float fast_uniform_float(Engine& engine) __attribute__((always_inline));
+
+template <class Engine>
+inline float fast_uniform_float(Engine& engine)
+{
+	return bits_to_float(static_cast<std::uint32_t>(engine() >> (EngineBits<Engine>::wide ? 32 : 0)));
+}
+
+/** @brief Two uniform floats in [0, 1) from one 64-bit word (low half first). */
+template <class Engine>
+inline std::pair<float, float> fast_uniform_float2(Engine& engine)
+{
+	if constexpr (EngineBits<Engine>::wide)
+	{
+		const std::uint64_t x = static_cast<std::uint64_t>(engine());
+		return {bits_to_float(static_cast<std::uint32_t>(x)), bits_to_float(static_cast<std::uint32_t>(x >> 32))};
+	}
+	else
+	{
+		const float a = bits_to_float(static_cast<std::uint32_t>(engine()));
+		return {a, bits_to_float(static_cast<std::uint32_t>(engine()))};
+	}
+}
+
+/** @brief Fills `out` with uniform doubles in [0, 1). Raw words are drawn in blocks and
+ * converted with the SIMD path. The stream equals repeated calls of `fast_uniform()`. */
+template <class Engine>
+void fast_uniform_fill(Engine& engine, std::span<double> out)
+{
+	constexpr size_t Block = EngineBits<Engine>::Block;
+	std::uint64_t words[Block];
+	for(size_t begin = 0; begin < out.size(); begin += Block)
+	{
+		const size_t n = (out.size() - begin < Block) ? out.size() - begin : Block;
+		EngineBits<Engine>::fill64(engine, std::span<std::uint64_t>(words, n));
+		bits_to_double(std::span<const std::uint64_t>(words, n), out.subspan(begin, n));
+	}
+}
+
+/** @brief Fills `out` with uniform floats in [0, 1), two floats per 64-bit draw (low half first).
+ * The stream equals repeated calls of `fast_uniform_float2()`. */
+template <class Engine>
+void fast_uniform_fill(Engine& engine, std::span<float> out)
+{
+	constexpr size_t Block = 2 * EngineBits<Engine>::Block;
+	std::uint32_t words[Block];
+	for(size_t begin = 0; begin < out.size(); begin += Block)
+	{
+		const size_t n = (out.size() - begin < Block) ? out.size() - begin : Block;
+		EngineBits<Engine>::fill32(engine, std::span<std::uint32_t>(words, n));
+		bits_to_float(std::span<const std::uint32_t>(words, n), out.subspan(begin, n));
+	}
+}
+
+
+//Reference - "Fast Random Integer Generation in an Interval", D. Lemire in ACM Transactions on Modeling and Computer Simulation Volume 29 Issue 1, 2019 Article 3
+
+
+/** @brief High and low 64 bits of the 128-bit product `a * b`. */
+inline std::uint64_t mul_64x64(std::uint64_t a, std::uint64_t b, std::uint64_t& low) __attribute__((always_inline));
+
+inline std::uint64_t mul_64x64(std::uint64_t a, std::uint64_t b, std::uint64_t& low)
+{
+#if defined(__SIZEOF_INT128__)
+	const unsigned __int128 m = static_cast<unsigned __int128>(a) * b;
+	low = static_cast<std::uint64_t>(m);
+	return static_cast<std::uint64_t>(m >> 64);
+#else
+	const std::uint64_t a_lo = a & 0xFFFFFFFFULL, a_hi = a >> 32;
+	const std::uint64_t b_lo = b & 0xFFFFFFFFULL, b_hi = b >> 32;
+	const std::uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi, hl = a_hi * b_lo, hh = a_hi * b_hi;
+	const std::uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFULL) + (hl & 0xFFFFFFFFULL);
+	low = (mid << 32) | (ll & 0xFFFFFFFFULL);
+	return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+/** @brief Lemire's nearly divisionless bounded integer in [0, range) from 32-bit words.
+ * The high half of `word * range` is the result; only when the low half falls below `range`
+ * (probability `range / 2^32`) is the exact rejection threshold computed with one modulo.
+ * `next()` returns the next word, `range` must not be 0. */
+template <class NextWord>
+inline std::uint32_t lemire32(std::uint32_t range, NextWord&& next) __attribute__((always_inline));
+
+template <class NextWord>
+inline std::uint32_t lemire32(std::uint32_t range, NextWord&& next)
+{
+	std::uint64_t m = std::uint64_t(next()) * range;
+	std::uint32_t low = static_cast<std::uint32_t>(m);
+	if(low < range)
+	{
+		const std::uint32_t threshold = static_cast<std::uint32_t>(-range) % range;
+		while(low < threshold)
+		{
+			m = std::uint64_t(next()) * range;
+			low = static_cast<std::uint32_t>(m);
+		}
+	}
+	return static_cast<std::uint32_t>(m >> 32);
+}
+
+/** @brief 64-bit `lemire32()`. */
+template <class NextWord>
+inline std::uint64_t lemire64(std::uint64_t range, NextWord&& next) __attribute__((always_inline));
+
+template <class NextWord>
+inline std::uint64_t lemire64(std::uint64_t range, NextWord&& next)
+{
+	std::uint64_t low;
+	std::uint64_t high = mul_64x64(next(), range, low);
+	if(low < range)
+	{
+		const std::uint64_t threshold = (0 - range) % range;
+		while(low < threshold)
+			{ high = mul_64x64(next(), range, low); }
+	}
+	return high;
+}
+
+
+/** @brief Unbiased uniform integer in [lo, hi] with Lemire's method, directly from the raw
+ * Engine output. 32-bit engines use one draw per attempt for ranges up to 2^32 (two beyond),
+ * 64-bit engines one draw per attempt. Signed types are supported.
+ * \attention `lo` must not be larger than `hi`. */
+template <class IntType, class Engine>
+inline IntType fast_uniform_int(Engine& engine, IntType lo, IntType hi)
+{
+	static_assert(std::is_integral_v<IntType> && sizeof(IntType) <= 8, "fast_uniform_int() requires an integer type of at most 64 bits.");
+	using Bits = EngineBits<Engine>;
+	using UInt = std::make_unsigned_t<IntType>;
+
+	const std::uint64_t range = std::uint64_t(UInt(UInt(hi) - UInt(lo))) + 1; //0 for the full 64-bit range
+
+	constexpr std::uint64_t Full32 = std::uint64_t(1) << 32;
+
+	std::uint64_t offset = 0;
+	if(!Bits::wide && range != 0 && range <= Full32)
+	{
+		if constexpr (!Bits::wide)
+		{
+			offset = (range == Full32) ? Bits::word32(engine)
+			       : lemire32(std::uint32_t(range), [&engine]() { return Bits::word32(engine); });
+		}
+	}
+	else
+	{
+		offset = (range == 0) ? Bits::word64(engine)
+		       : lemire64(range, [&engine]() { return Bits::word64(engine); });
+	}
+	return IntType(UInt(UInt(lo) + UInt(offset)));
+}
+
+/** @brief Fills `out` with `fast_uniform_int(engine, lo, hi)`. Raw words are drawn in blocks
+ * (through `generate(span)` where available) and rejections take the next word of the block,
+ * so the stream and the final Engine state equal the scalar calls; no word is drawn ahead. */
+template <class IntType, class Engine>
+void fast_uniform_int_fill(Engine& engine, std::span<IntType> out, IntType lo, IntType hi)
+{
+	static_assert(std::is_integral_v<IntType> && sizeof(IntType) <= 8, "fast_uniform_int_fill() requires an integer type of at most 64 bits.");
+	using Bits = EngineBits<Engine>;
+	using UInt = std::make_unsigned_t<IntType>;
+	constexpr size_t Block = Bits::Block;
+
+	const std::uint64_t range = std::uint64_t(UInt(UInt(hi) - UInt(lo))) + 1;
+	const bool narrow = !Bits::wide && range != 0 && range <= (std::uint64_t(1) << 32);
+
+	//Pull words from a block that never holds more words than outputs are still missing
+	auto run = [&](auto word, auto bound) {
+		using Word = decltype(word);
+		Word words[Block];
+		size_t pos = 0, filled = 0, done = 0;
+		auto next = [&]() -> Word {
+			if(pos == filled)
+			{
+				filled = std::min(Block, out.size() - done);
+				pos = 0;
+				if constexpr (sizeof(Word) == 4)
+					{ Bits::fill32(engine, std::span<std::uint32_t>(words, filled)); }
+				else
+					{ Bits::fill64(engine, std::span<std::uint64_t>(words, filled)); }
+			}
+			return words[pos++];
+		};
+		for(; done < out.size(); done++)
+			{ out[done] = IntType(UInt(UInt(lo) + UInt(bound(next)))); }
+	};
+
+	if(narrow)
+	{
+		const std::uint32_t r = std::uint32_t(range);
+		if(range == (std::uint64_t(1) << 32))
+			{ run(std::uint32_t(0), [](auto& next) { return next(); }); }
+		else
+			{ run(std::uint32_t(0), [r](auto& next) { return lemire32(r, next); }); }
+	}
+	else
+	{
+		if(range == 0)
+			{ run(std::uint64_t(0), [](auto& next) { return next(); }); }
+		else
+			{ run(std::uint64_t(0), [range](auto& next) { return lemire64(range, next); }); }
+	}
+}
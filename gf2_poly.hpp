@@ -0,0 +1,287 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <array>
+#include <bit>
+
+//Reference - "Efficient Jump Ahead for F2-Linear Random Number Generators", H. Haramoto, M. Matsumoto, T. Nishimura, F. Panneton, P. L'Ecuyer in INFORMS Journal on Computing Volume 20 Issue 3, 2008 Pages 385-390
+
+
+/** @brief Dense polynomial over GF(2). Bit `i` of `Words` is the coefficient of `x^i`. */
+class GF2Poly
+{
+public:
+	std::vector<std::uint64_t> Words; //!< Packed coefficients, lowest degree first
+
+	//0
+	/** @brief Constructor -> Zero polynomial with room for `bits` coefficients. */
+	explicit GF2Poly(size_t bits = 0): Words((bits + 63) / 64, 0) {}
+
+	//1
+	/** @brief Returns the coefficient of `x^i`. */
+	bool get(size_t i) const {
+		const size_t w = i / 64;
+		return w < Words.size() && ((Words[w] >> (i % 64)) & 1);
+		}
+
+	//2
+	/** @brief Flips the coefficient of `x^i`. The polynomial grows if needed. */
+	void flip(size_t i) {
+		const size_t w = i / 64;
+		if(w >= Words.size())
+			{ Words.resize(w + 1, 0); }
+		Words[w] ^= std::uint64_t(1) << (i % 64);
+		}
+
+	//3
+	/** @brief Returns the degree of the polynomial, `-1` for the zero polynomial. */
+	long degree() const {
+		for(size_t w = Words.size(); w > 0; w--)
+		{
+			if(Words[w - 1] != 0)
+				{ return long(64 * (w - 1) + 63 - std::countl_zero(Words[w - 1])); }
+		}
+		return -1;
+		}
+
+	//4
+	/** @brief Adds (XOR) `other * x^shift` to the polynomial. */
+	void xor_shifted(const GF2Poly& other, size_t shift) {
+		const size_t word = shift / 64;
+		const unsigned bit = shift % 64;
+		const size_t needed = other.Words.size() + word + 1;
+		if(Words.size() < needed)
+			{ Words.resize(needed, 0); }
+
+		if(bit == 0)
+		{
+			for(size_t i = 0; i < other.Words.size(); i++)
+				{ Words[i + word] ^= other.Words[i]; }
+		}
+		else
+		{
+			for(size_t i = 0; i < other.Words.size(); i++)
+			{
+				Words[i + word] ^= other.Words[i] << bit;
+				Words[i + word + 1] ^= other.Words[i] >> (64 - bit);
+			}
+		}
+		}
+
+	friend bool operator==(const GF2Poly& lhs, const GF2Poly& rhs) {
+		const size_t size = (lhs.Words.size() > rhs.Words.size()) ? lhs.Words.size() : rhs.Words.size();
+		for(size_t i = 0; i < size; i++)
+		{
+			const std::uint64_t a = (i < lhs.Words.size()) ? lhs.Words[i] : 0;
+			const std::uint64_t b = (i < rhs.Words.size()) ? rhs.Words[i] : 0;
+			if(a != b)
+				{ return false; }
+		}
+		return true;
+		}
+};
+
+
+/** @brief Returns the characteristic polynomial (reciprocal of the minimal connection
+ * polynomial) of a bit sequence with the Berlekamp-Massey algorithm. At least twice the
+ * degree of the recurrence bits must be passed. Bits are packed; a sequence of
+ * 2 x 19937 bits takes about 0.2 s. */
+inline GF2Poly berlekamp_massey(const std::vector<std::uint8_t>& seq) {
+	const size_t n_bits = seq.size();
+	const size_t capacity = n_bits / 2 + 128;
+
+	GF2Poly C(capacity), B(capacity);
+	C.flip(0);
+	B.flip(0);
+
+	//Bit i of R is seq[k - i], i.e. the sequence seen backwards from the current index.
+	std::vector<std::uint64_t> R((capacity + 63) / 64, 0);
+
+	size_t L = 0;
+	size_t m = 1;
+
+	for(size_t k = 0; k < n_bits; k++)
+	{
+		const size_t filled = k / 64 + 1;
+		for(size_t w = (filled < R.size() ? filled : R.size() - 1); w > 0; w--)
+			{ R[w] = (R[w] << 1) | (R[w - 1] >> 63); }
+		R[0] = (R[0] << 1) | (seq[k] & 1);
+
+		const size_t live = L / 64 + 1;
+		std::uint64_t acc = 0;
+		for(size_t w = 0; w < live && w < C.Words.size(); w++)
+			{ acc ^= C.Words[w] & R[w]; }
+		const bool discrepancy = std::popcount(acc) & 1;
+
+		if(!discrepancy)
+			{ m++; }
+		else if(2 * L <= k)
+		{
+			GF2Poly T = C;
+			C.xor_shifted(B, m);
+			L = k + 1 - L;
+			B = std::move(T);
+			m = 1;
+		}
+		else
+		{
+			C.xor_shifted(B, m);
+			m++;
+		}
+	}
+
+	GF2Poly P(L + 1);
+	for(size_t i = 0; i <= L; i++)
+	{
+		if(C.get(L - i))
+			{ P.flip(i); }
+	}
+	return P;
+	}
+
+
+/** @brief Arithmetic modulo a fixed polynomial `P` over GF(2). Only the operations needed
+ * for jump-ahead are provided - squaring, multiplication and division by `x`, and `x^e mod P`.
+ * The 64 bit-shifted copies of `P` are precomputed so that reduction is word aligned.
+ * \attention `P(0)` must be 1, otherwise `x` has no inverse modulo `P`. */
+class GF2Modulus
+{
+	GF2Poly P; //!< Modulus
+	size_t Degree; //!< Degree of the modulus
+	size_t PolyWords; //!< Number of words of a reduced polynomial
+	std::vector<std::vector<std::uint64_t>> Shifted; //!< P << k for k in [0, 64)
+
+public:
+
+	//0
+	/** @brief Constructor -> Precomputes the shifted copies of the modulus. */
+	explicit GF2Modulus(const GF2Poly& modulus): P(modulus), Degree(size_t(modulus.degree())), PolyWords(Degree / 64 + 1) {
+		Shifted.resize(64);
+		for(unsigned k = 0; k < 64; k++)
+		{
+			GF2Poly tmp(Degree + 64 + 64);
+			tmp.xor_shifted(P, k);
+			tmp.Words.resize(PolyWords + 1, 0);
+			Shifted[k] = std::move(tmp.Words);
+		}
+		}
+
+	//1
+	size_t degree() const { return Degree; }
+	const GF2Poly& modulus() const { return P; }
+
+	//2
+	/** @brief Returns `x^(distance * 2^shift) mod P`. */
+	GF2Poly x_pow(std::uint64_t distance, unsigned shift = 0) const {
+		GF2Poly r(Degree + 1);
+		r.Words.resize(PolyWords, 0);
+		r.flip(0);
+
+		//Left-to-right binary exponentiation - squarings and multiplications by x only.
+		for(int b = 63 - std::countl_zero(distance | 1); b >= 0; b--)
+		{
+			r = square(r);
+			if((distance >> b) & 1)
+				{ r = mul_x(r); }
+		}
+		if(distance == 0)
+			{ return r; }
+
+		for(unsigned s = 0; s < shift; s++)
+			{ r = square(r); }
+		return r;
+		}
+
+	//3
+	/** @brief Returns `a^2 mod P`. Squaring over GF(2) spreads the bits, only the reduction costs. */
+	GF2Poly square(const GF2Poly& a) const {
+		std::vector<std::uint64_t> wide(2 * PolyWords + 1, 0);
+		for(size_t i = 0; i < a.Words.size() && i < PolyWords; i++)
+		{
+			wide[2 * i] = spread(std::uint32_t(a.Words[i]));
+			wide[2 * i + 1] = spread(std::uint32_t(a.Words[i] >> 32));
+		}
+		reduce(wide);
+
+		GF2Poly r;
+		wide.resize(PolyWords);
+		r.Words = std::move(wide);
+		return r;
+		}
+
+	//4
+	/** @brief Returns `a * x mod P`. */
+	GF2Poly mul_x(const GF2Poly& a) const {
+		GF2Poly r = a;
+		r.Words.resize(PolyWords, 0);
+		std::uint64_t carry = 0;
+		for(size_t i = 0; i < PolyWords; i++)
+		{
+			const std::uint64_t next = r.Words[i] >> 63;
+			r.Words[i] = (r.Words[i] << 1) | carry;
+			carry = next;
+		}
+		if(r.get(Degree))
+		{
+			for(size_t i = 0; i < PolyWords; i++)
+				{ r.Words[i] ^= P.Words[i]; }
+		}
+		return r;
+		}
+
+	//5
+	/** @brief Returns `a * x^-1 mod P`. */
+	GF2Poly div_x(const GF2Poly& a) const {
+		GF2Poly r = a;
+		r.Words.resize(PolyWords, 0);
+		if(r.Words[0] & 1)
+		{
+			for(size_t i = 0; i < PolyWords; i++)
+				{ r.Words[i] ^= P.Words[i]; }
+		}
+		for(size_t i = 0; i < PolyWords; i++)
+		{
+			const std::uint64_t next = (i + 1 < PolyWords) ? r.Words[i + 1] : 0;
+			r.Words[i] = (r.Words[i] >> 1) | (next << 63);
+		}
+		return r;
+		}
+
+private:
+//Helper Functions
+
+	/** @brief Interleaves the 32 bits of `v` with zeros. */
+	static std::uint64_t spread(std::uint32_t v) {
+		std::uint64_t x = v;
+		x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+		x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+		x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+		x = (x | (x << 2)) & 0x3333333333333333ULL;
+		x = (x | (x << 1)) & 0x5555555555555555ULL;
+		return x;
+		}
+
+	/** @brief Reduces `w` modulo `P` in place, clearing the coefficients from the top down. */
+	void reduce(std::vector<std::uint64_t>& w) const {
+		for(size_t word = w.size(); word-- > Degree / 64; )
+		{
+			while(true)
+			{
+				std::uint64_t bits = w[word];
+				if(word == Degree / 64)
+					{ bits &= ~std::uint64_t(0) << (Degree % 64); }
+				if(bits == 0)
+					{ break; }
+
+				const size_t top = 64 * word + 63 - std::countl_zero(bits);
+				const size_t offset = top - Degree;
+				const auto& shifted = Shifted[offset % 64];
+				const size_t base = offset / 64;
+				for(size_t i = 0; i < shifted.size() && i + base < w.size(); i++)
+					{ w[i + base] ^= shifted[i]; }
+			}
+		}
+		}
+};
@@ -0,0 +1,305 @@
+#pragma once
+
+#include "yaml.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <bit>
+#include <vector>
+#include <algorithm>
+
+
+/** @brief Opt-in instrumentation of `PRNGWrapper`, enabled by defining `PRNGW_INSTRUMENT`
+ * before the wrapper is included (`-DPRNGW_INSTRUMENT`). Without it the hooks expand to
+ * nothing and the wrapper carries no instrumentation member.
+ * Counters are per wrapper. A wrapper is used by one thread at a time, so an update is a
+ * relaxed load and store (no locked read-modify-write) and any thread may take a snapshot. */
+
+
+/** @brief Counters kept by `PRNGInstrument`. */
+enum class prng_counter_t : std::uint8_t
+{
+	UniDraws,      //!< Uniform numbers (`uni()`, `uni_fast*()`, `uni_fill()`, `parallel_fill()`)
+	GaussDraws,    //!< Gaussian numbers (`gauss()`, `gauss_fill()`)
+	IntDraws,      //!< Bounded integers (`uniform_int()`, `uniform_int_fill()`)
+	EngineDraws,   //!< Raw engine words (`engine_fill()`)
+	FillCalls,     //!< Bulk calls (`*_fill()`)
+	EntropyBytes,  //!< Bytes read from `Urandom`
+	Seedings,      //!< Seeding calls (`new_seeds()`, `new_master_seed()`, `new_single_seed()`, ...)
+	WarmUps,       //!< `warm_up()` calls
+	Jumps,         //!< `jump()` calls
+	Checkpoints,   //!< States written (`snapshot()`, `save_state()`, `save_seeds()`)
+	Restores,      //!< States read (`restore()`, `load_state()`, `old_seeds()`)
+	Count
+};
+
+/** @brief Timed operations of `PRNGInstrument`. */
+enum class prng_timer_t : std::uint8_t
+{
+	NewSeeds,      //!< `new_seeds()`
+	WarmUp,        //!< `warm_up()`
+	Checkpoint,    //!< `snapshot()`, `save_state()`
+	Restore,       //!< `restore()`, `load_state()`
+	ParallelFill,  //!< `parallel_fill()`
+	Count
+};
+
+inline constexpr size_t PRNGCounterCount = size_t(prng_counter_t::Count);
+inline constexpr size_t PRNGTimerCount = size_t(prng_timer_t::Count);
+
+inline constexpr const char* prng_counter_names[PRNGCounterCount] = {
+	"uni_draws", "gauss_draws", "int_draws", "engine_draws", "fill_calls", "entropy_bytes",
+	"seedings", "warm_ups", "jumps", "checkpoints", "restores"};
+
+inline constexpr const char* prng_timer_names[PRNGTimerCount] = {
+	"new_seeds", "warm_up", "checkpoint", "restore", "parallel_fill"};
+
+
+/** @brief Timing histogram snapshot. Bucket `i` counts the durations in [2^i, 2^(i+1)) ns,
+ * bucket 0 also holds 0 ns and the last bucket everything above. */
+struct TimingHistogram
+{
+	static constexpr size_t BucketCount = 40; //!< Up to ~9 minutes
+
+	std::uint64_t Count = 0; //!< Timed calls
+	std::uint64_t TotalNs = 0; //!< Sum of the durations
+	std::uint64_t MaxNs = 0; //!< Longest duration
+	std::array<std::uint64_t, BucketCount> Buckets{}; //!< log2 buckets
+
+	double mean() const { return Count == 0 ? 0.0 : double(TotalNs) / double(Count); }
+
+	/** @brief Upper bound (ns) of the bucket holding the `p`-th percentile, at most `MaxNs`. */
+	std::uint64_t percentile(double p) const {
+		const std::uint64_t rank = static_cast<std::uint64_t>(p / 100.0 * double(Count) + 0.5);
+		std::uint64_t seen = 0;
+		for(size_t i = 0; i < BucketCount; i++)
+		{
+			seen += Buckets[i];
+			if(seen >= rank && seen != 0)
+				{ return std::min(std::uint64_t(2) << i, MaxNs); }
+		}
+		return MaxNs;
+		}
+
+	static size_t bucket(std::uint64_t ns) {
+		return ns == 0 ? 0 : std::min<size_t>(size_t(std::bit_width(ns)) - 1, BucketCount - 1);
+		}
+};
+
+
+/** @brief Snapshot of a `PRNGInstrument`, see `PRNGWrapper::stats()`. */
+struct PRNGStats
+{
+	std::array<std::uint64_t, PRNGCounterCount> Counters{}; //!< Indexed by `prng_counter_t`
+	std::array<TimingHistogram, PRNGTimerCount> Timings{}; //!< Indexed by `prng_timer_t`
+	std::vector<std::uint64_t> DistDraws; //!< Draws of every additional distribution (`draw<Index>()`, `draw_fill()`)
+
+	std::uint64_t operator[](prng_counter_t c) const { return Counters[size_t(c)]; }
+	const TimingHistogram& operator[](prng_timer_t t) const { return Timings[size_t(t)]; }
+
+	/** @brief Adds another snapshot, e.g. to total the streams of a pool. */
+	PRNGStats& operator+=(const PRNGStats& other) {
+		for(size_t i = 0; i < PRNGCounterCount; i++)
+			{ Counters[i] += other.Counters[i]; }
+		for(size_t t = 0; t < PRNGTimerCount; t++)
+		{
+			TimingHistogram& h = Timings[t];
+			const TimingHistogram& o = other.Timings[t];
+			h.Count += o.Count;
+			h.TotalNs += o.TotalNs;
+			h.MaxNs = std::max(h.MaxNs, o.MaxNs);
+			for(size_t i = 0; i < TimingHistogram::BucketCount; i++)
+				{ h.Buckets[i] += o.Buckets[i]; }
+		}
+		if(DistDraws.size() < other.DistDraws.size())
+			{ DistDraws.resize(other.DistDraws.size()); }
+		for(size_t i = 0; i < other.DistDraws.size(); i++)
+			{ DistDraws[i] += other.DistDraws[i]; }
+		return *this;
+		}
+
+	/** @brief Writes the snapshot under `key` at the current level of `yaml`.
+	 * Timers that never ran are skipped; the buckets are written as a flow array. */
+	void write_yaml(YamlFile& yaml, const std::string& key = "prng_stats") const {
+		yaml.push_level(key);
+		yaml.push_level("counters");
+		for(size_t i = 0; i < PRNGCounterCount; i++)
+			{ yaml.add_val(prng_counter_names[i], Counters[i]); }
+		if(!DistDraws.empty())
+			{ yaml.add_flow_array("dist_draws", DistDraws); }
+		yaml.pop_level();
+
+		yaml.push_level("timings");
+		for(size_t t = 0; t < PRNGTimerCount; t++)
+		{
+			const TimingHistogram& h = Timings[t];
+			if(h.Count == 0)
+				{ continue; }
+			yaml.push_level(prng_timer_names[t]);
+			yaml.add_val("count", h.Count);
+			yaml.add_val("total_ns", h.TotalNs);
+			yaml.add_val("mean_ns", h.mean());
+			yaml.add_val("p50_ns", h.percentile(50.0));
+			yaml.add_val("p99_ns", h.percentile(99.0));
+			yaml.add_val("max_ns", h.MaxNs);
+			yaml.add_flow_array("log2_buckets", h.Buckets);
+			yaml.pop_level();
+		}
+		yaml.pop_level();
+		yaml.pop_level();
+		}
+};
+
+
+/** @brief Live counters and timing histograms of one wrapper. Copies take a snapshot of the
+ * counters, hence instrumentation does not change whether a class holding it can be copied
+ * (`PRNGWrapper` itself is not copyable, as its `Urandom` is not).
+ *  DistCount - Number of additional distributions of the wrapper. */
+template <size_t DistCount>
+class PRNGInstrument
+{
+	struct Timer
+	{
+		std::atomic<std::uint64_t> Count{0};
+		std::atomic<std::uint64_t> TotalNs{0};
+		std::atomic<std::uint64_t> MaxNs{0};
+		std::array<std::atomic<std::uint64_t>, TimingHistogram::BucketCount> Buckets{};
+	};
+
+	std::array<std::atomic<std::uint64_t>, PRNGCounterCount> Counters{};
+	std::array<std::atomic<std::uint64_t>, DistCount> DistDraws{};
+	std::array<Timer, PRNGTimerCount> Timers{};
+
+	/** @brief Single writer - a relaxed load and store instead of a locked `fetch_add`. */
+	static void bump(std::atomic<std::uint64_t>& a, std::uint64_t n) __attribute__((always_inline)) {
+		a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+		}
+
+	static void copy(std::atomic<std::uint64_t>& to, const std::atomic<std::uint64_t>& from) {
+		to.store(from.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+
+public:
+
+	PRNGInstrument() = default;
+
+	/** @brief Copy constructor -> Takes a snapshot of the counters of `other` (relaxed loads). */
+	PRNGInstrument(const PRNGInstrument& other) { *this = other; }
+
+	/** @brief Replaces the counters by a snapshot of `other` (owning thread only). */
+	PRNGInstrument& operator=(const PRNGInstrument& other) {
+		if(this == &other)
+			{ return *this; }
+		for(size_t i = 0; i < PRNGCounterCount; i++)
+			{ copy(Counters[i], other.Counters[i]); }
+		for(size_t i = 0; i < DistCount; i++)
+			{ copy(DistDraws[i], other.DistDraws[i]); }
+		for(size_t t = 0; t < PRNGTimerCount; t++)
+		{
+			copy(Timers[t].Count, other.Timers[t].Count);
+			copy(Timers[t].TotalNs, other.Timers[t].TotalNs);
+			copy(Timers[t].MaxNs, other.Timers[t].MaxNs);
+			for(size_t i = 0; i < TimingHistogram::BucketCount; i++)
+				{ copy(Timers[t].Buckets[i], other.Timers[t].Buckets[i]); }
+		}
+		return *this;
+		}
+
+	//0
+	void count(prng_counter_t c, std::uint64_t n = 1) __attribute__((always_inline)) {
+		bump(Counters[size_t(c)], n);
+		}
+
+	/** @brief Counts `n` draws of the additional distribution `index`. */
+	void count_dist(size_t index, std::uint64_t n = 1) __attribute__((always_inline)) {
+		bump(DistDraws[index], n);
+		}
+
+	//1
+	/** @brief Records one duration of operation `t`. */
+	void time(prng_timer_t t, std::uint64_t ns) {
+		Timer& timer = Timers[size_t(t)];
+		bump(timer.Count, 1);
+		bump(timer.TotalNs, ns);
+		bump(timer.Buckets[TimingHistogram::bucket(ns)], 1);
+		if(ns > timer.MaxNs.load(std::memory_order_relaxed))
+			{ timer.MaxNs.store(ns, std::memory_order_relaxed); }
+		}
+
+	//2
+	/** @brief Copies the counters (relaxed - exact once the owning thread is done). */
+	PRNGStats snapshot() const {
+		PRNGStats stats;
+		for(size_t i = 0; i < PRNGCounterCount; i++)
+			{ stats.Counters[i] = Counters[i].load(std::memory_order_relaxed); }
+		stats.DistDraws.resize(DistCount);
+		for(size_t i = 0; i < DistCount; i++)
+			{ stats.DistDraws[i] = DistDraws[i].load(std::memory_order_relaxed); }
+		for(size_t t = 0; t < PRNGTimerCount; t++)
+		{
+			const Timer& timer = Timers[t];
+			TimingHistogram& h = stats.Timings[t];
+			h.Count = timer.Count.load(std::memory_order_relaxed);
+			h.TotalNs = timer.TotalNs.load(std::memory_order_relaxed);
+			h.MaxNs = timer.MaxNs.load(std::memory_order_relaxed);
+			for(size_t i = 0; i < TimingHistogram::BucketCount; i++)
+				{ h.Buckets[i] = timer.Buckets[i].load(std::memory_order_relaxed); }
+		}
+		return stats;
+		}
+
+	//3
+	/** @brief Zeroes everything (owning thread only). */
+	void reset() {
+		for(auto& c : Counters)
+			{ c.store(0, std::memory_order_relaxed); }
+		for(auto& c : DistDraws)
+			{ c.store(0, std::memory_order_relaxed); }
+		for(auto& timer : Timers)
+		{
+			timer.Count.store(0, std::memory_order_relaxed);
+			timer.TotalNs.store(0, std::memory_order_relaxed);
+			timer.MaxNs.store(0, std::memory_order_relaxed);
+			for(auto& b : timer.Buckets)
+				{ b.store(0, std::memory_order_relaxed); }
+		}
+		}
+};
+
+
+/** @brief Times a scope into a `PRNGInstrument`. */
+template <class Instrument>
+class InstrumentTimer
+{
+	Instrument& Target;
+	prng_timer_t Which;
+	std::chrono::steady_clock::time_point Start;
+
+public:
+	InstrumentTimer(Instrument& target, prng_timer_t which):
+		Target(target), Which(which), Start(std::chrono::steady_clock::now())
+	{}
+
+	~InstrumentTimer() {
+		const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - Start).count();
+		Target.time(Which, static_cast<std::uint64_t>(ns));
+		}
+
+	InstrumentTimer(const InstrumentTimer&) = delete;
+	InstrumentTimer& operator=(const InstrumentTimer&) = delete;
+};
+
+
+#ifdef PRNGW_INSTRUMENT
+	#define PRNGW_COUNT(counter, n) this->Instrument.count(prng_counter_t::counter, (n))
+	#define PRNGW_COUNT_DIST(index, n) this->Instrument.count_dist((index), (n))
+	#define PRNGW_TIME(timer) InstrumentTimer prngw_scope_timer(this->Instrument, prng_timer_t::timer)
+#else
+	#define PRNGW_COUNT(counter, n) ((void)0)
+	#define PRNGW_COUNT_DIST(index, n) ((void)0)
+	#define PRNGW_TIME(timer) ((void)0)
+#endif
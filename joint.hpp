@@ -0,0 +1,259 @@
+#pragma once
+
+#include "stat_tests.hpp"
+#include "parallel.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <span>
+#include <new>
+#include <memory>
+#include <thread>
+#include <numeric>
+#include <algorithm>
+
+
+/** @brief Cache-line aligned block of memory that is carved into the coordinate buffers
+ * (structure of arrays) and a scratch buffer of a sampling block. Allocated once per thread
+ * and reused for every block, so sampling allocates nothing per point. */
+template <size_t Dims>
+class SampleArena
+{
+	struct AlignedDelete
+	{
+		void operator()(double* p) const { ::operator delete[](p, std::align_val_t(PRNGW_CACHE_LINE)); }
+	};
+
+	static constexpr size_t Pad = PRNGW_CACHE_LINE / sizeof(double); //!< Doubles per cache line
+
+	std::unique_ptr<double[], AlignedDelete> Memory; //!< Dims coordinate buffers followed by the scratch buffer
+	size_t Capacity; //!< Points per block
+	size_t Stride; //!< Doubles per coordinate buffer, padded to a cache line
+
+public:
+
+	//0
+	/** @brief Constructor -> Allocates room for blocks of `capacity` points. */
+	explicit SampleArena(size_t capacity):
+		Capacity(capacity), Stride((capacity + Pad - 1) / Pad * Pad)
+	{
+		const size_t doubles = 2 * Dims * Stride; //Coordinates + scratch of Dims draws per point
+		Memory.reset(static_cast<double*>(::operator new[](doubles * sizeof(double), std::align_val_t(PRNGW_CACHE_LINE))));
+	}
+
+	//1
+	size_t capacity() const { return Capacity; }
+
+	//2
+	/** @brief Coordinate buffer of dimension `d` for a block of `n` points. */
+	std::span<double> coords(size_t d, size_t n) { return {Memory.get() + d * Stride, n}; }
+
+	//3
+	/** @brief Scratch buffer of `n * Dims` doubles (e.g. raw interleaved draws). */
+	std::span<double> scratch(size_t n) { return {Memory.get() + Dims * Stride, n * Dims}; }
+};
+
+
+/** @brief One block of points handed to the draw callback of `joint_sample()`. */
+template <size_t Dims>
+struct JointBlock
+{
+	std::array<std::span<double>, Dims> Coords; //!< Coordinate `d` of every point, to be filled
+	std::span<double> Scratch; //!< Room for `Dims * size()` doubles
+
+	size_t size() const { return Coords[0].size(); }
+
+	/** @brief Fills the block with consecutive tuples of one stream - `fill(raw)` must fill
+	 * `Dims * size()` numbers, point `i` is `(raw[i Dims], ..., raw[i Dims + Dims - 1])`.
+	 * This is the layout that exposes correlations between consecutive draws. */
+	template <class FillFn>
+	void fill_tuples(FillFn&& fill) {
+		fill(Scratch);
+		const size_t n = size();
+		for(size_t d = 0; d < Dims; d++)
+		{
+			double* out = Coords[d].data();
+			const double* in = Scratch.data() + d;
+			for(size_t i = 0; i < n; i++)
+				{ out[i] = in[i * Dims]; }
+		}
+		}
+};
+
+
+/** @brief Histogram over a box in `Dims` dimensions with equal width bins per dimension
+ * (flat row-major counts, 64-bit). Points with any coordinate outside the box are counted
+ * in `outside()`. */
+template <size_t Dims>
+class JointHistogram
+{
+	std::array<double, Dims> Lower; //!< Lower edges
+	std::array<double, Dims> Scale; //!< Bins per unit
+	std::array<size_t, Dims> Bins; //!< Bins per dimension
+	std::array<size_t, Dims> Strides; //!< Flat index stride of every dimension
+	std::vector<std::uint64_t> Counts; //!< Flat counts
+	std::uint64_t Outside = 0; //!< Points outside the box
+
+public:
+
+	//0
+	/** @brief Constructor -> Box [lower, upper) with `bins[d]` bins in dimension `d`. */
+	JointHistogram(std::array<double, Dims> lower, std::array<double, Dims> upper, std::array<size_t, Dims> bins):
+		Lower(lower), Bins(bins)
+	{
+		size_t total = 1;
+		for(size_t d = Dims; d-- > 0; )
+		{
+			Scale[d] = double(bins[d]) / (upper[d] - lower[d]);
+			Strides[d] = total;
+			total *= bins[d];
+		}
+		Counts.assign(total, 0);
+	}
+
+	//1
+	/** @brief Adds a block of points given as coordinate buffers. */
+	void add(const std::array<std::span<double>, Dims>& coords) {
+		constexpr size_t Chunk = 256;
+		const size_t n = coords[0].size();
+		std::array<size_t, Chunk> index;
+		std::array<bool, Chunk> inside;
+
+		for(size_t begin = 0; begin < n; begin += Chunk)
+		{
+			const size_t len = std::min(Chunk, n - begin);
+			index.fill(0);
+			inside.fill(true);
+
+			//One dimension at a time, so the loads stay sequential
+			for(size_t d = 0; d < Dims; d++)
+			{
+				const double* x = coords[d].data() + begin;
+				for(size_t i = 0; i < len; i++)
+				{
+					const double offset = (x[i] - Lower[d]) * Scale[d];
+					const bool ok = offset >= 0.0 && offset < double(Bins[d]);
+					inside[i] = inside[i] && ok;
+					index[i] += (ok ? size_t(offset) : 0) * Strides[d];
+				}
+			}
+
+			for(size_t i = 0; i < len; i++)
+			{
+				if(inside[i])
+					{ Counts[index[i]]++; }
+				else
+					{ Outside++; }
+			}
+		}
+		}
+
+	//2
+	/** @brief Adds the counts of another histogram with the same layout. */
+	void merge(const JointHistogram& other) {
+		for(size_t i = 0; i < Counts.size(); i++)
+			{ Counts[i] += other.Counts[i]; }
+		Outside += other.Outside;
+		}
+
+	//3
+	/** @brief Clears all the counts. */
+	void reset() {
+		std::fill(Counts.begin(), Counts.end(), 0);
+		Outside = 0;
+		}
+
+	//4
+	size_t bins(size_t d) const { return Bins[d]; }
+	size_t size() const { return Counts.size(); }
+	std::uint64_t outside() const { return Outside; }
+	const std::vector<std::uint64_t>& counts() const { return Counts; }
+
+	/** @brief Count of the bin with the given per-dimension indices. */
+	std::uint64_t count(const std::array<size_t, Dims>& bin) const {
+		size_t flat = 0;
+		for(size_t d = 0; d < Dims; d++)
+			{ flat += bin[d] * Strides[d]; }
+		return Counts[flat];
+		}
+
+	/** @brief Lower edge of bin `i` of dimension `d`. */
+	double edge(size_t d, size_t i) const { return Lower[d] + double(i) / Scale[d]; }
+
+	/** @brief Number of points inside the box. */
+	std::uint64_t inside() const { return std::accumulate(Counts.begin(), Counts.end(), std::uint64_t(0)); }
+
+	/** @brief Number of points, including the ones outside the box. */
+	std::uint64_t total() const { return inside() + Outside; }
+
+	//5
+	/** @brief Marginal counts of dimension `d` (points inside the box only). */
+	std::vector<std::uint64_t> marginal(size_t d) const {
+		std::vector<std::uint64_t> m(Bins[d], 0);
+		for(size_t flat = 0; flat < Counts.size(); flat++)
+			{ m[(flat / Strides[d]) % Bins[d]] += Counts[flat]; }
+		return m;
+		}
+
+	//6
+	/** @brief Chi-square test of independence of the coordinates - the joint counts against
+	 * the product of the marginals. Returns the statistic and its p-value; a small p-value
+	 * means the coordinates (e.g. consecutive draws) are correlated.
+	 * \attention Every expected count should be at least ~5 for the p-value to be meaningful. */
+	StatTestResult independence() const {
+		const double n = double(inside());
+		std::array<std::vector<std::uint64_t>, Dims> marginals;
+		size_t dof_sum = 0;
+		for(size_t d = 0; d < Dims; d++)
+		{
+			marginals[d] = marginal(d);
+			dof_sum += Bins[d] - 1;
+		}
+
+		double chi2 = 0.0;
+		for(size_t flat = 0; flat < Counts.size(); flat++)
+		{
+			double expected = n;
+			for(size_t d = 0; d < Dims; d++)
+				{ expected *= double(marginals[d][(flat / Strides[d]) % Bins[d]]) / n; }
+			if(expected > 0.0)
+			{
+				const double diff = double(Counts[flat]) - expected;
+				chi2 += diff * diff / expected;
+			}
+		}
+
+		const double dof = double(Counts.size() - 1 - dof_sum);
+		return {"joint independence", chi2, stat_detail::chi2_pvalue(chi2, dof)};
+		}
+};
+
+
+/** @brief Samples `points` points into a joint histogram on `threads` threads (0 for all
+ * the cores), see `parallel_partials()`. Every thread owns a `SampleArena`, draws blocks of
+ * points with `draw(thread, block)` into the arena (structure of arrays) and bins them.
+ * @param histogram Histogram with the requested layout, receives the counts.
+ * @param draw Callable `void(size_t thread, JointBlock<Dims>& block)`, called concurrently.
+ * @param points Number of points. */
+template <size_t Dims, class DrawFn>
+void joint_sample(JointHistogram<Dims>& histogram, DrawFn&& draw, std::uint64_t points, size_t threads = 0)
+{
+	constexpr size_t BlockSize = 4096; //!< Points per `draw` call
+
+	parallel_partials(histogram, points, threads, [&](size_t t, JointHistogram<Dims>& h, std::uint64_t begin, std::uint64_t end) {
+		SampleArena<Dims> arena(BlockSize);
+		JointBlock<Dims> block;
+		for(std::uint64_t i = begin; i < end; i += BlockSize)
+		{
+			const size_t n = static_cast<size_t>(std::min<std::uint64_t>(BlockSize, end - i));
+			for(size_t d = 0; d < Dims; d++)
+				{ block.Coords[d] = arena.coords(d, n); }
+			block.Scratch = arena.scratch(n);
+
+			draw(t, block);
+			h.add(block.Coords);
+		}
+	});
+}
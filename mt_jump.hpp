@@ -0,0 +1,242 @@
+#pragma once
+
+#include "gf2_poly.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <random>
+#include <vector>
+#include <sstream>
+#include <type_traits>
+
+//Reference - "Efficient Jump Ahead for F2-Linear Random Number Generators", H. Haramoto, M. Matsumoto, T. Nishimura, F. Panneton, P. L'Ecuyer in INFORMS Journal on Computing Volume 20 Issue 3, 2008 Pages 385-390
+
+
+/** @brief Jump-ahead for the Mersenne Twister family. Only specialized for `std::mersenne_twister_engine`. */
+template <class Engine>
+struct MTJump;
+
+/** @brief True for every `std::mersenne_twister_engine` (`std::mt19937`, `std::mt19937_64`, ...). */
+template <class Engine>
+inline constexpr bool is_mersenne_twister_v = false;
+
+template <typename UIntType, size_t w, size_t n, size_t m, size_t r, UIntType a, size_t u, UIntType d,
+          size_t s, UIntType b, size_t t, UIntType c, size_t l, UIntType f>
+inline constexpr bool is_mersenne_twister_v<std::mersenne_twister_engine<UIntType, w, n, m, r, a, u, d, s, b, t, c, l, f>> = true;
+
+
+/** @brief Jump-ahead for `std::mersenne_twister_engine`. The engine state is advanced by
+ * `D` steps by evaluating `(x^D mod P)(T)` on the state with Horner's rule, where `T` is the
+ * state transition and `P` its characteristic polynomial. `P` is computed once per process
+ * (Berlekamp-Massey on 2 x 19937 output bits, about 0.2 s) and cached; afterwards a jump
+ * costs `O(log D)` modular squarings plus one Horner pass - about 25-35 ms for a few million
+ * steps, growing by about 5 ms per doubling of the distance (about 0.25 s for 2^64).
+ * The jumped engine gives the stream of `discard()` but may not compare `==` equal to it,
+ * since the state is written back in a different (equivalent) layout.
+ * The engine state is accessed through its textual representation, both the standard
+ * (`x[i-n] ... x[i-1]`) and the libstdc++ (`x[0] ... x[n-1] p`) layouts are handled. */
+template <typename UIntType, size_t w, size_t n, size_t m, size_t r, UIntType a, size_t u, UIntType d,
+          size_t s, UIntType b, size_t t, UIntType c, size_t l, UIntType f>
+struct MTJump<std::mersenne_twister_engine<UIntType, w, n, m, r, a, u, d, s, b, t, c, l, f>>
+{
+	using engine_type = std::mersenne_twister_engine<UIntType, w, n, m, r, a, u, d, s, b, t, c, l, f>;
+
+	static constexpr size_t degree = n * w - r; //!< Dimension of the state space (19937)
+
+	/** @brief Distances below this are cheaper with `engine.discard()`. */
+	static constexpr unsigned long long discard_threshold = 1ULL << 22;
+
+	//0
+	/** @brief Returns the cached modulus (characteristic polynomial of the recurrence). */
+	static const GF2Modulus& modulus() {
+		static const GF2Modulus mod(characteristic_polynomial());
+		return mod;
+		}
+
+	//1
+	/** @brief Returns `x^(distance * 2^shift) mod P`. The result can be reused with `apply()`
+	 * to advance many engines by the same distance. */
+	static GF2Poly jump_polynomial(std::uint64_t distance, unsigned shift = 0) {
+		return modulus().x_pow(distance, shift);
+		}
+
+	//2
+	/** @brief Advances the engine by `distance * 2^shift` outputs.
+	 * Short distances are forwarded to `engine.discard()`.
+	 * \return false, with the engine unchanged, if its textual state layout is not recognised. */
+	static bool jump(engine_type& engine, std::uint64_t distance, unsigned shift = 0) {
+		if(distance == 0)
+			{ return true; }
+		if(shift < 64 && distance < (discard_threshold >> shift))
+		{
+			engine.discard(distance << shift);
+			return true;
+		}
+		if(!State().read(engine))
+			{ return false; } //Before the polynomial, which is computed from the same layout
+		return apply(engine, jump_polynomial(distance, shift));
+		}
+
+	//3
+	/** @brief Advances the engine by `D` outputs where `poly = x^D mod P` and `D` is at least `2 n`.
+	 * \return false, with the engine unchanged, if its textual state layout is not recognised. */
+	static bool apply(engine_type& engine, const GF2Poly& poly) {
+		const GF2Modulus& mod = modulus();
+
+		State state;
+		if(!state.read(engine))
+			{ return false; }
+
+		//Step once so that the window lies in the image of T (the oldest word's unused low
+		//bits are then consistent), and compensate the steps that the layout implies.
+		state.window.next();
+		GF2Poly q = poly;
+		for(size_t i = 0; i < state.lag; i++)
+			{ q = mod.div_x(q); }
+
+		Window result;
+		horner(result, state.window, q, mod.degree());
+		state.window = result;
+		return state.write(engine);
+		}
+
+private:
+
+	static constexpr UIntType word_mask = (w == sizeof(UIntType) * 8) ? UIntType(~UIntType(0)) : UIntType((UIntType(1) << w) - 1);
+	static constexpr UIntType lower_mask = UIntType((UIntType(1) << r) - 1);
+	static constexpr UIntType upper_mask = UIntType(~lower_mask & word_mask);
+
+	/** @brief Sliding window of the last `n` words of the recurrence, oldest word at `Pos`. */
+	struct Window
+	{
+		std::vector<UIntType> X = std::vector<UIntType>(n, 0);
+		size_t Pos = 0;
+
+		/** @brief Computes the next word of the recurrence and drops the oldest. */
+		inline UIntType next() __attribute__((always_inline)) {
+			const size_t p1 = (Pos + 1 == n) ? 0 : Pos + 1;
+			const size_t pm = (Pos + m >= n) ? Pos + m - n : Pos + m;
+			const UIntType y = (X[Pos] & upper_mask) | (X[p1] & lower_mask);
+			const UIntType word = X[pm] ^ (y >> 1) ^ ((y & 1) ? a : UIntType(0));
+			X[Pos] = word;
+			Pos = p1;
+			return word;
+			}
+
+		/** @brief Adds (XOR) another window word by word, oldest words aligned. */
+		void add(const Window& other) {
+			//Split into runs that do not wrap around either buffer, so the inner loop vectorizes.
+			size_t i = Pos;
+			size_t j = other.Pos;
+			size_t left = n;
+			while(left > 0)
+			{
+				size_t run = n - ((i > j) ? i : j);
+				if(run > left)
+					{ run = left; }
+				UIntType* dst = X.data() + i;
+				const UIntType* src = other.X.data() + j;
+				for(size_t k = 0; k < run; k++)
+					{ dst[k] ^= src[k]; }
+				i = (i + run == n) ? 0 : i + run;
+				j = (j + run == n) ? 0 : j + run;
+				left -= run;
+			}
+			}
+
+		/** @brief Returns the words oldest first. */
+		std::vector<UIntType> ordered() const {
+			std::vector<UIntType> out(n);
+			for(size_t k = 0; k < n; k++)
+				{ out[k] = X[(Pos + k) % n]; }
+			return out;
+			}
+	};
+
+	/** @brief Engine state read from the textual representation. */
+	struct State
+	{
+		Window window; //!< Window whose next generated word is `x[i]`
+		size_t lag = 0; //!< Steps between the window position and the engine position
+		bool libstdcxx = false; //!< Layout `x[0] ... x[n-1] p`
+
+		bool read(const engine_type& engine) {
+			std::stringstream ss;
+			ss << engine;
+			std::vector<unsigned long long> tokens;
+			unsigned long long token;
+			while(ss >> token)
+				{ tokens.push_back(token); }
+
+			if(tokens.size() == n + 1) //libstdc++ - block regenerated array and read index
+			{
+				libstdcxx = true;
+				const size_t p = static_cast<size_t>(tokens[n]);
+				//The window generates x[k+n] while the engine returns x[k+p] next. After the
+				//extra step the result must be the window ending before x[k+p+D], i.e. n+1-p steps less.
+				lag = n + 1 - p;
+			}
+			else if(tokens.size() == n) //Standard - x[i-n] ... x[i-1]
+				{ lag = 1; }
+			else
+				{ return false; }
+
+			for(size_t k = 0; k < n; k++)
+				{ window.X[k] = static_cast<UIntType>(tokens[k]); }
+			window.Pos = 0;
+			return true;
+			}
+
+		/** @brief Writes the window back; the engine is unchanged if the stream rejects the text. */
+		bool write(engine_type& engine) const {
+			std::stringstream ss;
+			for(auto x : window.ordered())
+				{ ss << static_cast<unsigned long long>(x) << ' '; }
+			if(libstdcxx)
+				{ ss << n; } //Next call regenerates the block from the window
+			engine_type jumped;
+			ss >> jumped;
+			if(ss.fail())
+				{ return false; }
+			engine = jumped;
+			return true;
+			}
+	};
+
+	/** @brief Computes `result = q(T) window` with Horner's rule. */
+	static void horner(Window& result, Window& window, const GF2Poly& q, size_t deg) {
+		long top = q.degree();
+		if(top > long(deg))
+			{ top = long(deg); }
+
+		for(long i = top; i >= 0; i--)
+		{
+			result.next();
+			if(q.get(size_t(i)))
+				{ result.add(window); }
+		}
+		}
+
+	/** @brief Characteristic polynomial of the recurrence from 2 x degree output bits. */
+	static GF2Poly characteristic_polynomial() {
+		Window window;
+		engine_type engine;
+		State state;
+		state.read(engine);
+		window = state.window;
+
+		std::vector<std::uint8_t> bits(2 * degree);
+		for(auto& bit : bits)
+			{ bit = window.next() & 1; }
+		return berlekamp_massey(bits);
+		}
+};
+
+
+/** @brief Advances a Mersenne Twister engine by `distance * 2^shift` outputs.
+ * \return false, with the engine unchanged, if the standard library's state layout is not recognised. */
+template <class Engine>
+bool mt_jump(Engine& engine, std::uint64_t distance, unsigned shift = 0)
+{
+	return MTJump<Engine>::jump(engine, distance, shift);
+}
@@ -3,13 +3,35 @@
 
 #pragma once
 
-#include "urandom.h"
+#include "urandom.hpp"
+#include "ziggurat.hpp"
+#include "mt_jump.hpp"
+#include "splitmix.hpp"
+#include "checkpoint.hpp"
+#include "bench.hpp"
+#include "stat_tests.hpp"
+#include "fast_uniform.hpp"
+#include "alias_table.hpp"
+#include "instrument.hpp"
 
 #include <random>
 #include <vector>
+#include <span>
+#include <type_traits>
+#include <tuple>
+#include <concepts>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <chrono>
 #include <sstream>
 #include <fstream>
+#include <iomanip>
+#include <string>
+#include <string_view>
+
+#include <nlohmann/json.hpp>
 
 
 /// This block can be used to change the type rnd_error_t to any integer type of your choice.
@@ -17,6 +39,14 @@ using rnd_error_cast_t = unsigned int;
 #define RND_INT_CAST static_cast<rnd_error_cast_t>
 
 
+/** \brief True for engines whose jump-ahead reaches every substream of `PRNGWrapper::new_master_seed()`:
+ * Mersenne Twister engines and engines with a `jump(distance, shift)` that cannot fail.
+ * `wyrand` is not one of them, its `jump()` rejects the 2^64 distance between substreams. */
+template <class Engine>
+inline constexpr bool has_stream_jump_v = is_mersenne_twister_v<Engine> ||
+	requires(Engine& e) { { e.jump(std::uint64_t(1), 1u) } -> std::same_as<void>; };
+
+
 
 
 
@@ -25,8 +55,12 @@ using rnd_error_cast_t = unsigned int;
  *  object as the template arguement and constructs a wrapper object that manages
  *  **seeding, checkpointing, and distribution states**. 
  *  PRNGType - PRNG Engine
- *  DISCARD - Number of states to discard for warm-up (optional). */
-template <class PRNGType, size_t DISCARD = 0>
+ *  DISCARD - Number of states to discard for warm-up (optional).
+ *  GaussDist - Gaussian distribution (optional), `std::normal_distribution<double>` or
+ *  the table driven `ziggurat_normal_distribution<double>`.
+ *  Dists - Additional distributions (optional), e.g. `std::exponential_distribution<double>`,
+ *  `std::poisson_distribution<int>`, drawn with `draw<Index>()` or `draw<Dist>()`. */
+template <class PRNGType, size_t DISCARD = 0, class GaussDist = std::normal_distribution<double>, class... Dists>
 class PRNGWrapper
 {
 
@@ -36,28 +70,45 @@ private:
 public:
 
 	/** @brief Error codes used within the library. */
-	enum prng_error_t : uintfast8_t
+	enum prng_error_t : std::uint_fast8_t
 	{
 		Success = 0,          //!< Operation Successful
 		EntropyShortage = 1,  //!< Seeds available are less than the state size
 		SeedNotFound = 2,     //!< Seed(s) Not Found
 		FileError = 3,        //!< File Not Found Error
-		DistStateNotFound = 4 //!< Distribution(s) states not found
+		DistStateNotFound = 4, //!< Distribution(s) states not found
+		JumpUnsupported = 5   //!< Engine cannot advance by the requested distance
 
 	};
 
-	constexpr PRNGType Engine; //!< PRNG Engine
-	std::normal_distribution<double> Gauss_dist; //!< Gaussian distribution
+	PRNGType Engine; //!< PRNG Engine
+	GaussDist Gauss_dist; //!< Gaussian distribution
 	std::uniform_real_distribution<double> Uni_dist; //!< Uniform distribution
 
-	constexpr typename result_type = Engine::result_type; 
-	//!< Defination of the return type of the Engine generator
+	using dist_set_type = std::tuple<Dists...>; //!< Additional distributions
+	[[no_unique_address]] dist_set_type Dist_set; //!< Additional distributions, no storage without any
+
+	using result_type = typename PRNGType::result_type; //!< Return type of the Engine
 	
 	std::vector<result_type> Seed_list; //!< Stores the last used seed value(s)
+
+	std::uint64_t Master_seed = 0; //!< Master seed of the last `new_master_seed()`
+	std::uint64_t Stream_id = 0; //!< Substream of the last `new_master_seed()`
+	bool Master_seeded = false; //!< The Engine was seeded by `new_master_seed()`
+	bool Compact_seeds = false; //!< Compact mode - the Seed_list is re-expanded from the master seed on demand
+
+#ifdef PRNGW_INSTRUMENT
+	mutable PRNGInstrument<sizeof...(Dists)> Instrument; //!< Draw counters and timings (`instrument.hpp`)
+#endif
 	
-	//bool Warmed_up = false; //! Flag that indicates whether the engine has warmed up.
-	//size_t Discarded_last; //! Last value of the number of States discarded for warm-up of the engine.
-	constexpr size_t DiscardLength = DISCARD; //! Totlal sum of the number of States discarded for warm-up of the engine.
+	bool Warmed_up = false; //!< Flag that indicates whether the engine has warmed up.
+	size_t Discard_length = DISCARD; //!< Number of states discarded for warm-up of the engine.
+
+	float Float_spare = 0.0f; //!< Second float in [0, 1) of the last word drawn by `uni_fast_float()`/`uni_fast_fill()`
+	bool Has_float_spare = false; //!< `Float_spare` is the next float of the fast uniform stream
+
+	static constexpr unsigned StreamShift = 64; //!< Substreams of `new_master_seed()` are 2^StreamShift numbers long
+	static constexpr size_t ParallelFillGrain = size_t(1) << 16; //!< Smallest block per thread of `parallel_fill()`
 
 	
 
@@ -67,80 +118,78 @@ public:
 	PRNGWrapper(size_t discard = 0) {
 		if(discard != 0)
 		{
-			DiscardLength = discard;
+			Discard_length = discard;
 		}
 		
 		//Explicit Initialization of ranges
       	Uni_dist.param(std::uniform_real_distribution<double>::param_type(0.0, 1.0));
-      	Gauss_dist.param(std::normal_distribution<double>::param_type(0.0, 1.0));
+      	Gauss_dist.param(typename GaussDist::param_type(0.0, 1.0));
 		}
 
 
 	//1
-	/** @brief Set the limits of the gaussian (normal) distribution.
-	 * @param lower the lower limit.
-	 * @param upper the upper limit. */
-	void set_gauss_limits(double lower, double upper) __attribute__((always_inline)) {
-		static_assert(upper > lower, "The upper limit must be larger than the lower limit.");
-		Gauss_dist.param(std::normal_distribution<double>::param_type(lower, upper));	
+	/** @brief Set the parameters of the gaussian (normal) distribution.
+	 * @param mean the mean.
+	 * @param stddev the standard deviation, ignored unless positive. */
+	void set_gauss_limits(double mean, double stddev) __attribute__((always_inline)) {
+		if(stddev > 0.0)
+			{ Gauss_dist.param(typename GaussDist::param_type(mean, stddev)); }
 		}
 
 
 	//2
-	/** @brief Set the limits of the uniform distribution. 
+	/** @brief Set the limits of the uniform distribution. Ignored unless `upper > lower`.
 	 * @param lower the lower limit.
 	 * @param upper the upper limit. */
 	void set_uni_limits(double lower, double upper) __attribute__((always_inline)) {
-		static_assert(upper > lower, "The upper limit must be larger than the lower limit.");
-		Uni_dist.param(std::uniform_real_distribution<double>::param_type(lower, upper));	
+		if(upper > lower)
+			{ Uni_dist.param(std::uniform_real_distribution<double>::param_type(lower, upper)); }
 		}
 
 
 	//3
-	/** @brief Warmups up the engine by discarding the given number.
-	 * @param No parameter - `Discard_length` if not zero, else Non-deterministic discards. 
-	 * \param (optional) - "any" - Non-deterministic discards. 
-	 * \param (optional) discard_arg - Number of values discarded. - */
-	[[Incomplete]]
+	/** @brief Warms up the engine by discarding numbers (with `jump()`).
+	 * @param discard_arg (optional) Number of values discarded; 0 discards `Discard_length` values.
+	 * @param str_t (optional) "any" - discards a non-deterministic number (< 2^20) of values, as
+	 * does a call without arguments while `Discard_length` is zero. The random length is added to
+	 * `Discard_length`; `FileError` is returned if the source cannot be read. */
 	prng_error_t warm_up(size_t discard_arg = 0, const char* str_t  = "") {
+		PRNGW_TIME(WarmUp);
+		PRNGW_COUNT(WarmUps, 1);
+		size_t discard = discard_arg;
+
 		//No option is provided or "any" is passed
-		if((discard_length == 0 && discard_arg == 0) || str_t == "any")
+		if((Discard_length == 0 && discard_arg == 0) || std::string_view(str_t) == "any")
 		{
 			//Discard a random length
-			
-			nondet.open();
-			rnd_error_cast_t advance = nondet.get(); 
+			rnd_error_cast_t advance = 0;
+			const bool read = nondet.open() && nondet.get(advance);
 			nondet.close();
-			
-			Discard_length += advance; //Adds to the discard_count
-			Engine.discard(advance);
-			return advance;
-		}
+			if(!read)
+				{ return prng_error_t::FileError; }
+			advance &= 0xFFFFF;
+			PRNGW_COUNT(EntropyBytes, sizeof(advance));
 
-		else if(discard_arg != 0)
-		{
-			Engine.discard(discard_arg);
-			Discard_length += discard_arg;
-			return discard_arg;
+			discard = advance;
+			Discard_length += advance; //Adds to the discard_count
 		}
 
-		//Repeated Invocations will keep discarding equal to discard_length
-		else if(Discard_length !=0) //Can be invoked in the case of an Old Seed
-		{
-			engine.discard(discard_length);
-			if(warmed_up)
-				discard_length += discard_length;
-			return discard_length;
-		}
+		//Repeated Invocations will keep discarding equal to Discard_length
+		else if(discard_arg == 0)
+			{ discard = Discard_length; }
 
-		else
-			return 0;
+		const prng_error_t status = this->jump(discard);
+		Warmed_up = (status == prng_error_t::Success);
+		return status;
 		}
 
 
 	//4
-	/** @brief Returns a vector of all the seed values in the current Seed_list. */
-	std::vector<Engine::result_type> get_seedlist() const {
+	/** @brief Returns a vector of all the seed values in the current Seed_list.
+	 * In compact mode the seeds are re-expanded from the master seed. */
+	std::vector<result_type> get_seedlist() const {
+		if(this->compact())
+			{ return this->master_seed_list(); }
 		return Seed_list;
 		}
 
@@ -148,9 +197,14 @@ public:
 	/** @brief Returns the first seed value from the seed sequence. 
 	 * Usual use case is debugging by comparing runs without going through the whole
 	 * sequence of seeds. */
-	Engine::result_type inline get_first_seed() const {
+	result_type inline get_first_seed() const {
+		if(this->compact())
+		{
+			SplitMix64 mix{Master_seed};
+			return static_cast<result_type>(mix());
+		}
 		if(Seed_list.size() > 0)
-			return seed_list[0];
+			return Seed_list[0];
 		else
 			return 0;
 		}
@@ -159,7 +213,7 @@ public:
 	/** @brief Use the default seed of the generator as the seed. */
 	prng_error_t inline default_seed() __attribute__((flatten)) {
 		
-		return new_single_seed(Engine::default_seed);
+		return new_single_seed(PRNGType::default_seed);
 		}
 
 	//7
@@ -167,56 +221,77 @@ public:
 	prng_error_t inline seed_by_time() __attribute__((flatten)) {
 		
 		auto seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-		return new_single_seed(seed);
+		return new_single_seed(static_cast<result_type>(seed));
 		
 		}
 
 	//6
 	/** @brief Seed the Engine with a passed single seed.
+	 * \attention A single seed fills one entry of the Seed_list, hence `seed_status()` reports `EntropyShortage`.
 	 * @param x_seed Single seed value */
 	template <typename SeedType>
 	prng_error_t inline new_single_seed(SeedType x_seed) {
 		
-		if(!Seed_list.is_empty())
+		if(!Seed_list.empty())
 		{
 			this->free_seedlist();
 		}
 		
-		seed_list.emplace_back(x_seed); //Write to Seed_list
-		Engine.seed(x_seed);
+		Seed_list.emplace_back(static_cast<result_type>(x_seed)); //Write to Seed_list
+		Master_seeded = false;
+		PRNGW_COUNT(Seedings, 1);
+		Engine.seed(static_cast<result_type>(x_seed));
 		Warmed_up = false;
 		return this->seed_status();
 		}
 
 	//8.0
-	/** @brief Seeds the PRNG using `Engine::state_size` seeds from a non-deterministic source.
-	 * @param do_discard (optional) Supress engine warm-up by passing `true`. */
+	/** @brief Seeds the PRNG using `PRNGType::state_size` seeds from a non-deterministic source.
+	 * In compact mode a single 64-bit master seed is read instead and expanded (`new_master_seed()`).
+	 * @param do_discard (optional) Warms the engine up by `Discard_length` numbers. */
 	prng_error_t inline new_seeds(bool do_discard = true) {
+		PRNGW_TIME(NewSeeds);
 		
-		Seed_list.reserve(Engine::state_size);
+		if(Compact_seeds)
+		{
+			std::uint64_t master = 0;
+			const bool open_status = nondet.open() && nondet.get(master);
+			nondet.close();
+			PRNGW_COUNT(EntropyBytes, open_status * sizeof(master));
+			if(!open_status)
+				{ return prng_error_t::FileError; }
+
+			prng_error_t status = this->new_master_seed(master);
+			Warmed_up = do_discard;
+			if(do_discard)
+				{ this->jump(Discard_length); }
+			return status;
+		}
+
+		Master_seeded = false;
+		Seed_list.resize(PRNGType::state_size);
 
 	    bool open_status = nondet.open();
-	    
-	    for(unsigned int i = 0; i < Engine::state_size; i++)
-	    {
-	    	Seed_list.emplace_back(nondet.get<result_type>());
-	    }
+	    open_status = open_status && nondet.get_n(std::span<result_type>(Seed_list)); //One bulk read
 	    nondet.close();
+	    PRNGW_COUNT(EntropyBytes, open_status * Seed_list.size() * sizeof(result_type));
+	    PRNGW_COUNT(Seedings, 1);
 	    
 	    std::seed_seq seeds(std::begin(Seed_list), std::end(Seed_list));
 	    Engine.seed(seeds);
 	    
 	    Warmed_up = do_discard;
-	    Engine.discard(do_discard * DiscardLength);
+	    if(do_discard)
+	    	{ this->jump(Discard_length); }
 
-	    return (!open_status) * prng_error_t::FileError + 
-	            (open_status) * prng_error_t::Success;
+	    return open_status ? prng_error_t::Success : prng_error_t::FileError;
 		}
 
 	//8.1
 	/** \brief Alias for `new_seeds()`. */
-	prng_error_t inline new_state(bool do_discard = true) __attribute__ ((weak, alias ("new_seeds")));
-
+	prng_error_t inline new_state(bool do_discard = true) {
+		return this->new_seeds(do_discard);
+		}
 
 	//9
 	/** \brief Saves seeds to a ASCII file. This function cannot handle `json` files.
@@ -226,84 +301,69 @@ public:
 	 *  cases. */
 	prng_error_t inline save_seeds(std::string filename) {
 		
-		std::ifstream fout(filename, std::ios::out);
+		if(has_ext(filename, "json"))
+			{ return prng_error_t::FileError; }
+
+		std::ofstream fout(filename, std::ios::out);
 		if(!fout.is_open())
 			{ return prng_error_t::FileError; }
-		
-		if(has_ext(filename, "json"))
-		{
-			fout.close();
-			return prng_error_t::FileError;
-		}
 
-		else
+		PRNGW_COUNT(Checkpoints, 1);
+		for(const auto seed : this->get_seedlist())
 		{
-			for(unsigned int i = 0; i < Seed_list.size(); i++)
-			{
-				fout << Seed_list[i] << '\n';
-			}
-			fout.close();
-			return this->seed_status();
+			fout << seed << '\n';
 		}
+		fout.close();
+		return this->seed_status();
 
 		} //End of save_seeds()
 
 
 	//10
-	/** @brief Loads "old" seeds from a file. 
-	 * \attention If a json state file is provided, only the "engine_state" is used as seeds — the distribution states are ignored. */
+	/** @brief Loads "old" seeds from a file and seeds the Engine with them.
+	 * \attention If a json state file is provided, only its "seed_list" is used — the engine and distribution states are ignored. */
 	prng_error_t old_seeds(std::string filename) {
 
-	    seed_list.reserve(Engine::state_size);
-
 	    std::ifstream seed_file(filename, std::ios::in);
-	    
 	    if(!seed_file.is_open())
-	    {
-	    	return RND_INT_CAST(rnd_error_t::FileError);
-	    }
+	    	{ return prng_error_t::FileError; }
 		    
-	    if(this->has_json_ext(filename))
-	    {
-	    	json jfile;
-	    	jfile << seed_file;
+	    PRNGW_COUNT(Restores, 1);
+	    std::vector<result_type> seeds_read;
 
-	    	if(jfile.contains("engine_state"))
-	    	{
-	    		Engine << jfile["engine_state"];
-	    		Seed_list = jfile["engine_state"].get<std::vector<Engine::result_type>>();
-	   	 		Warmed_up = false;
-	    		this->reload_seeds();
-
-	    		return seed_status();
-	    	}
-
-	    	else
-	    		{ return RNDCAST(rnd_error_t::SeedNotFound); }
+	    if(has_ext(filename, "json"))
+	    {
+	    	nlohmann::json jfile = nlohmann::json::parse(seed_file, nullptr, false);
+	    	if(jfile.is_discarded() || !jfile.contains("seed_list"))
+	    		{ return prng_error_t::SeedNotFound; }
+	    	seeds_read = jfile["seed_list"].template get<std::vector<result_type>>();
 	    }
 
 	    else //Assume simple line seperated ASCII values
 	    {
-	    	unsigned int seeds_read = 0; unsigned int tmp = 0;
-			while(seed_file >> tmp && seeds_read < Engine::state_size)
-			{
-				seed_list.emplace_back(tmp);
-				seeds_read++; 
-			}
-
-		    std::seed_seq seeds(std::begin(seed_list), std::end(seed_list));
-		    Engine.seed(seeds);
-		    
-		    return seed_status();
+	    	result_type tmp = 0;
+			while(seeds_read.size() < PRNGType::state_size && seed_file >> tmp)
+				{ seeds_read.push_back(tmp); }
 		}
 
+		if(seeds_read.empty())
+			{ return prng_error_t::SeedNotFound; }
+
+	    Seed_list = std::move(seeds_read);
+	    Master_seeded = false;
+	    Warmed_up = false;
+	    std::seed_seq seeds(std::begin(Seed_list), std::end(Seed_list));
+	    Engine.seed(seeds);
+	    return this->seed_status();
 		}
 
 	//10
-	/** @brief Repeatedly calls the passed generating function to generate a seed sequence of length `Engine::state_size`. */
-	prng_error_t generate_seed_with(Engine::result_type (*generating_fn)()) {
+	/** @brief Repeatedly calls the passed generating function to generate a seed sequence of length `PRNGType::state_size`. */
+	prng_error_t generate_seed_with(result_type (*generating_fn)()) {
 		
-		this->free_seedlist();
+		Seed_list.resize(PRNGType::state_size);
+		Master_seeded = false;
+		PRNGW_COUNT(Seedings, 1);
 		std::generate(Seed_list.begin(), Seed_list.end(), generating_fn);
 
 	    std::seed_seq seeds(std::begin(Seed_list), std::end(Seed_list));
@@ -311,101 +371,129 @@ public:
 
 	    Warmed_up = false;
 
-	    return RND_INT_CAST(this->seed_status());
+	    return this->seed_status();
 	    	
 		}
 
 
 	//11
-	/** \brief Save state of the Engine and Distributions to a json state file.
-	 * \param fileneame  state file that will be created or overriden. 
+	/** \brief Save state of the Engine and Distributions to a json state file. The states are the
+	 * text forms of the standard stream operators, next to the seed list and the master seed.
+	 * \param filename  state file that will be created or overriden. 
 	 * \param (optional) include_discard  Passing true includes the Discard_length parameter to the state file.
 	 * \attention If the param filename does not have a json extension '.json', the function will append it. */
-	prng_error_t save_state(const std::string filename, bool include_discard = false) {
-		using json = nlohmann::json;
-		json state_object;
+	prng_error_t save_state(std::string filename, bool include_discard = false) {
+		PRNGW_TIME(Checkpoint);
+		PRNGW_COUNT(Checkpoints, 1);
+		nlohmann::json state_object;
 				
-		std::ofstream fout(filename, std::ios::out);
-		state_object["engine_state"] << std::setw(4) << Engine; //Save engine state
-		state_object["gauss_state"] << std::setw(4) << Gauss_dist;
-		state_object["uni_state"] << std::setw(4) << Uni_dist;
+		state_object["engine_state"] = text_state(Engine); //Save engine state
+		state_object["gauss_state"] = text_state(Gauss_dist);
+		state_object["uni_state"] = text_state(Uni_dist);
+		if(Has_float_spare)
+			{ state_object["float_spare"] = Float_spare; }
+		if constexpr (sizeof...(Dists) > 0)
+			{ state_object["dist_set_state"] = this->dist_set_text(); }
+
+		if(Master_seeded)
+		{
+			state_object["master_seed"] = Master_seed;
+			state_object["stream_id"] = Stream_id;
+			state_object["compact_seeds"] = Compact_seeds;
+		}
+		if(!Seed_list.empty())
+			{ state_object["seed_list"] = Seed_list; }
 
 		if(include_discard)
 			{ state_object["discard"] = this->Discard_length; }
 
-		if(! this->has_json_ext(filename))
-			{ filename.append(".json") }
-		
+		if(!has_ext(filename, "json"))
+			{ filename.append(".json"); }
 
 		std::ofstream fout(filename, std::ios::out);
 		if(!fout.is_open())
-			return RND_INT_CAST(rnd_error_t::FileError);
+			{ return prng_error_t::FileError; }
 		
-		fout << state_object;
+		fout << std::setw(4) << state_object;
 		fout.close();
 
-		return RND_INT_CAST(rnd_error_t::Success);
+		return fout.fail() ? prng_error_t::FileError : prng_error_t::Success;
 
 		} //End of save_state()
 
 	//12
 	/** @brief Restore State of Engine and the distributions from a json state file. The json file must contain three fields: "engine_state", "gauss_state", and "uni_state". If any of these state is missing, the corresponding error is returned.
+	 * Nothing is changed unless the engine state is found.
 	 * @param filename : source state file.
 	 * @param (optional) include_discard: If the state file contains a "discard" field, the generator is warmed up with that discard value as well. */
 	prng_error_t load_state(const std::string filename,  bool include_discard = false) {
+		PRNGW_TIME(Restore);
+		PRNGW_COUNT(Restores, 1);
 
 		std::ifstream fin(filename, std::ios::in);
 		if(! fin.is_open())
-			return RND_INT_CAST(rnd_error_t::FileError);
+			{ return prng_error_t::FileError; }
+		
+		nlohmann::json state_object = nlohmann::json::parse(fin, nullptr, false);
+		fin.close();
+		if(state_object.is_discarded())
+			{ return prng_error_t::FileError; }
+
+		PRNGType engine;
+		if(!state_object.contains("engine_state") || !from_text(state_object["engine_state"], engine))
+			{ return prng_error_t::SeedNotFound; }
+		Engine = engine;
 		
-		using json = nlohmann::json;
-		json state_object;
-		fin >> state_object;
+		Seed_list = state_object.contains("seed_list") ?
+		            state_object["seed_list"].template get<std::vector<result_type>>() : std::vector<result_type>();
 
-		if(state_object.contains("engine_state"))
+		Master_seeded = state_object.contains("master_seed");
+		if(Master_seeded)
 		{
-			Engine << state_object["engine_state"];
-			Seed_list = state_object["engine_state"].get<std::vector<Engine::result_type>>();
+			Master_seed = state_object["master_seed"].template get<std::uint64_t>();
+			Stream_id = state_object.value("stream_id", std::uint64_t(0));
+			Compact_seeds = state_object.value("compact_seeds", false);
+			Seed_list = Compact_seeds ? std::vector<result_type>() : this->master_seed_list();
 		}
-		else { return RND_INT_CAST(rnd_error_t::SeedNotFound); }
-		
 
-		auto error_state = RND_INT_CAST(rnd_error_t::Success);
+		prng_error_t error_state = prng_error_t::Success;
 
+		if(!state_object.contains("gauss_state") || !from_text(state_object["gauss_state"], Gauss_dist))
+			{ error_state = prng_error_t::DistStateNotFound; }
 
-		if(state_object.contains("gauss_state"))
-			{ Gauss_dist << state_object["gauss_state"]; }
-		else {error_state = RND_INT_CAST(rnd_error_t::DistStateNotFound);}
+		if(!state_object.contains("uni_state") || !from_text(state_object["uni_state"], Uni_dist))
+			{ error_state = prng_error_t::DistStateNotFound; }
 
+		Has_float_spare = state_object.contains("float_spare") && state_object["float_spare"].is_number();
+		if(Has_float_spare)
+			{ Float_spare = state_object["float_spare"].template get<float>(); }
 
-		if(state_object.contains("uni_state"))
-			{ Uni_dist << state_object["uni_state"]; }
-		else {error_state = RND_INT_CAST(rnd_error_t::DistStateNotFound);}
+		if constexpr (sizeof...(Dists) > 0)
+		{
+			if(!state_object.contains("dist_set_state") ||
+			   !this->load_dist_set_text(state_object["dist_set_state"].template get<std::vector<std::string>>()))
+				{ error_state = prng_error_t::DistStateNotFound; }
+		}
 
 		if(state_object.contains("discard") && include_discard)
 		{	
-			this->Discard_length = state_object["discard"]; 
+			this->Discard_length = state_object["discard"].template get<size_t>(); 
 			this->warm_up();	
 		}
 
-		fin.close()
-		
-		if (error_state == RND_INT_CAST(rnd_error_t::DistStateNotFound) && this->seed_status() != rnd_error_t::SeedNotFound)
-		{
-			return error_state;
-		}
-
-		else
-			{ return RND_INT_CAST(this->seed_status()); }
-
-		
+		return error_state;
 		} //End of load_state()
 
 	//13
-	/** \brief Reloads the Engine with the Seed_list state.
+	/** \brief Reloads the Engine with the Seed_list state. Engines seeded by `new_master_seed()`
+	 * are re-seeded from the master seed and moved to the start of their substream again,
+	 * identically in compact mode.
 	 * \attention This function does not call warm_up(). */
 	prng_error_t reload_seeds() {
 
+		if(Master_seeded)
+			{ return this->new_master_seed(Master_seed, Stream_id); }
+
 	    std::seed_seq seeds(std::begin(Seed_list), std::end(Seed_list));
 	    Engine.seed(seeds);
 
@@ -417,7 +505,8 @@ public:
 	/** @brief Return a gaussian distributed random number in range [0,1)
 	 * from the PRNG Engine and the inbuilt Gaussian distribution. */
 	double gauss() __attribute__((flatten)) {
-		return Gauss_dist(this->Engine());
+		PRNGW_COUNT(GaussDraws, 1);
+		return Gauss_dist(this->Engine);
 		}
 
 
@@ -425,53 +514,60 @@ public:
 	/** @brief Return a uniformly distributed random number in range [0,1)
 	 * from the PRNG Engine and the inbuilt Uniform distribution. */
 	double uni() __attribute__((flatten)) {
-		return Uni_dist(this->Engine());
+		PRNGW_COUNT(UniDraws, 1);
+		return Uni_dist(this->Engine);
 		}
 
 
 	//16
-	/** @brief Return a gaussian distributed random number in range [0,1) from a
-	 *  non-deterministic engine. */
+	/** @brief Return a gaussian distributed random number (parameters of the inbuilt Gaussian
+	 *  distribution) from the non-deterministic source. The Engine stream is not touched. */
 	double gauss_nondet() __attribute__((flatten)) {
-		return Gauss_dist(this->get_nondet());
+		GaussDist dist(Gauss_dist.param());
+		NondetSource source{*this};
+		return dist(source);
 		}
 
 
 	//17
-	/** @brief Return a uniformly distributed random number in range [0,1) from a
-	 *  non-deterministic engine. */
+	/** @brief Return a uniformly distributed random number (limits of the inbuilt Uniform
+	 *  distribution) from the non-deterministic source. The Engine stream is not touched. */
 	double uni_nondet() __attribute__((flatten)) {
-		return Uni_dist(this->get_nondet());
+		std::uniform_real_distribution<double> dist(Uni_dist.param());
+		NondetSource source{*this};
+		return dist(source);
 		}
 
 
 	//18
-	/** \brief Get raw bytes - sizeof(Engine::result_type) - random number from a
+	/** \brief Get raw bytes - sizeof(result_type) - random number from a
 	 * non-determinstic source.
 	 * \warning This function does not close the non-deterministic source. */
-	Engine::result_type get_nondet() __attribute__((flatten)) {
+	result_type get_nondet() __attribute__((flatten)) {
 		
 		if(!nondet.is_open())
 		{
 			nondet.open();
 		}
 
-		return nondet.get<result_type>();
+		PRNGW_COUNT(EntropyBytes, sizeof(result_type));
+		return nondet.template get<result_type>();
 		}
 
 
 	//19
-	/** \brief Get raw bytes - sizeof(Engine::result_type) - random number from the
+	/** \brief Get raw bytes - sizeof(result_type) - random number from the
 	 *   non-determinstic source of the Wrapper. Recommended for single use as it closes
 	 *  the non-deterministic stream upon completion. */
-	Engine::result_type get_nondet_nclose() __attribute__((flatten)) {
+	result_type get_nondet_nclose() __attribute__((flatten)) {
 		
 		if(!nondet.is_open()) //Open
 		{
 			nondet.open();
 		}
 
-		auto tmp =  nondet.get<result_type>(); //Read
+		auto tmp =  nondet.template get<result_type>(); //Read
+		PRNGW_COUNT(EntropyBytes, sizeof(result_type));
 		
 		nondet.close(); //Close
 
@@ -482,71 +578,722 @@ public:
 	//20
 	/** \brief This function clears the Seed_list. */
 	void inline free_seedlist() __attribute__((flatten)) {
-		std::vector<Engine::result_type> tmp_vec;
-		tmp_vec.swap(seed_list);
-		//On exit -> seed_list(which is now tmp_vec) is destroyed and freed.
+		std::vector<result_type> tmp_vec;
+		tmp_vec.swap(Seed_list);
+		//On exit -> Seed_list(which is now tmp_vec) is destroyed and freed.
 		}
 
 
 	//21
 	/** \brief Returns the number of seeds in the current seed list. */
 	unsigned int inline get_seedlist_size() const {
+		if(this->compact())
+			{ return PRNGType::state_size; }
 		return Seed_list.size();
 		}
 
-	class Experimental
-	{
-	public:
-		template <size_t NoBins>
-		std::array<size_t, NoBins> sampler(samples_drawn, bool plot, bool restore_state = true)
+	//22
+	/** \brief Fills the passed span with raw numbers drawn from the PRNG Engine.
+	 * The stream is identical to repeated calls of `Engine()`. */
+	void engine_fill(std::span<result_type> out) __attribute__((flatten)) {
+		PRNGW_COUNT(EngineDraws, out.size());
+		PRNGW_COUNT(FillCalls, 1);
+		auto& engine = this->Engine;
+		for(auto& x : out)
+			{ x = engine(); }
+		}
+
+
+	//23
+	/** \brief Fills the passed span with uniformly distributed numbers from the PRNG
+	 * Engine and the inbuilt Uniform distribution.
+	 * The stream is bit-for-bit identical to repeated calls of `uni()`; `float` spans
+	 * receive the narrowed `double` draw. */
+	template <typename RealType>
+	__attribute__((flatten)) void uni_fill(std::span<RealType> out) {
+		static_assert(std::is_floating_point_v<RealType>, "uni_fill() requires a floating point span.");
+		PRNGW_COUNT(UniDraws, out.size());
+		PRNGW_COUNT(FillCalls, 1);
+		
+		//Local references allow the compiler to keep the objects in registers.
+		auto& engine = this->Engine;
+		auto& dist = this->Uni_dist;
+		for(auto& x : out)
+			{ x = static_cast<RealType>(dist(engine)); }
+		}
+
+
+	//24
+	/** \brief Fills the passed span with gaussian distributed numbers from the PRNG
+	 * Engine and the inbuilt Gaussian distribution.
+	 * The stream is bit-for-bit identical to repeated calls of `gauss()`; `float` spans
+	 * receive the narrowed `double` draw. Distributions with a batched path
+	 * (`ziggurat_normal_distribution::generate()`) are used through it. */
+	template <typename RealType>
+	__attribute__((flatten)) void gauss_fill(std::span<RealType> out) {
+		static_assert(std::is_floating_point_v<RealType>, "gauss_fill() requires a floating point span.");
+		PRNGW_COUNT(GaussDraws, out.size());
+		PRNGW_COUNT(FillCalls, 1);
+
+		if constexpr (std::is_same_v<RealType, typename GaussDist::result_type> &&
+		              requires { Gauss_dist.generate(Engine, out); })
+		{
+			Gauss_dist.generate(Engine, out);
+			return;
+		}
+
+		auto& engine = this->Engine;
+		auto& dist = this->Gauss_dist;
+		for(auto& x : out)
+			{ x = static_cast<RealType>(dist(engine)); }
+		}
+
+	//25
+	/** \brief Advances the Engine by `distance * 2^shift` numbers.
+	 * Mersenne Twister engines use polynomial jump-ahead (`mt_jump.hpp`), which costs tens of
+	 * milliseconds growing with `log2` of the distance; engines with their own `jump(distance, shift)`
+	 * (counter-based and small state engines) use it; other engines fall back to `discard()`.
+	 * \attention Returns `JumpUnsupported` if the distance does not fit `discard()`, if the
+	 * Engine's `jump()` rejects it (`wyrand` beyond its 2^64 period), or if the Mersenne Twister
+	 * state layout of the standard library is not recognised (the Engine is then unchanged). */
+	prng_error_t jump(std::uint64_t distance, unsigned shift = 0) {
+		PRNGW_COUNT(Jumps, 1);
+		return advance(this->Engine, distance, shift);
+		}
+
+	//26
+	/** \brief Seeds the full state of the Engine from a single 64-bit master seed and
+	 * moves it to the start of substream `stream`. The master seed is expanded with SplitMix64
+	 * into `state_size` seeds (saved in the Seed_list, unless in compact mode) and the Engine
+	 * is advanced with `jump()` by `stream * 2^StreamShift`, hence substreams of the same master
+	 * seed never overlap and are reproducible.
+	 * \attention Returns `JumpUnsupported` for engines that cannot jump (see `jump()`). */
+	prng_error_t new_master_seed(std::uint64_t master, std::uint64_t stream = 0) {
+		PRNGW_COUNT(Seedings, 1);
+		
+		Master_seed = master;
+		Stream_id = stream;
+		Master_seeded = true;
+
+		std::vector<result_type> seed_words = this->master_seed_list();
+	    std::seed_seq seeds(std::begin(seed_words), std::end(seed_words));
+	    Engine.seed(seeds);
+	    Warmed_up = false;
+
+	    if(Compact_seeds)
+	    	{ std::vector<result_type>().swap(Seed_list); }
+	    else
+	    	{ Seed_list = std::move(seed_words); }
+
+	    if(stream != 0)
+	    {
+	    	prng_error_t jump_status = this->jump(stream, StreamShift);
+	    	if(jump_status != prng_error_t::Success)
+	    		{ return jump_status; }
+	    }
+
+		return this->seed_status();
+		}
+
+	//27
+	/** \brief Returns the layout tag of the binary checkpoint records of this wrapper type.
+	 * Records are only restored by wrappers with the same tag. */
+	static constexpr std::uint64_t layout_tag() {
+		std::uint64_t tag = checkpoint_library_tag();
+		tag = checkpoint_tag(tag, sizeof(SeedRecord));
+		tag = checkpoint_tag(tag, sizeof(SpareRecord));
+		tag = checkpoint_tag(tag, sizeof(PRNGType));
+		tag = checkpoint_tag(tag, sizeof(GaussDist));
+		tag = checkpoint_tag(tag, sizeof(std::uniform_real_distribution<double>));
+		((tag = checkpoint_tag(tag, sizeof(Dists))), ...);
+		return tag;
+		}
+
+	//28
+	/** \brief Writes the binary state (Engine, distributions, discard length and master seed) into `record`. */
+	void snapshot(std::vector<std::byte>& record) const {
+		PRNGW_TIME(Checkpoint);
+		PRNGW_COUNT(Checkpoints, 1);
+		record.clear();
+		checkpoint_put(record, Engine);
+		checkpoint_put(record, Gauss_dist);
+		checkpoint_put(record, Uni_dist);
+		checkpoint_put(record, static_cast<std::uint64_t>(Discard_length));
+		checkpoint_put(record, SeedRecord{Master_seed, Stream_id, std::uint64_t(Master_seeded) | (std::uint64_t(Compact_seeds) << 1)});
+		checkpoint_put(record, SpareRecord{Float_spare, std::uint32_t(Has_float_spare)});
+		std::apply([&record](const auto&... dist) { (checkpoint_put(record, dist), ...); }, Dist_set);
+		}
+
+	//29
+	/** \brief Restores the binary state written by `snapshot()`.
+	 * The wrapper is left unchanged if the record is incomplete. */
+	prng_error_t restore(std::span<const std::byte> record) {
+		PRNGW_TIME(Restore);
+		PRNGW_COUNT(Restores, 1);
+		PRNGType engine;
+		GaussDist gauss;
+		std::uniform_real_distribution<double> uni;
+		std::uint64_t discard = 0;
+		SeedRecord seeds;
+		SpareRecord spare;
+		size_t offset = 0;
+
+		if(!checkpoint_get(record, offset, engine))
+			{ return prng_error_t::SeedNotFound; }
+		if(!checkpoint_get(record, offset, gauss) || !checkpoint_get(record, offset, uni) ||
+		   !checkpoint_get(record, offset, discard))
+			{ return prng_error_t::DistStateNotFound; }
+		if(!checkpoint_get(record, offset, seeds))
+			{ return prng_error_t::SeedNotFound; }
+		if(!checkpoint_get(record, offset, spare))
+			{ return prng_error_t::DistStateNotFound; }
+
+		dist_set_type dists;
+		const bool dists_found = std::apply([&](auto&... dist) { return (checkpoint_get(record, offset, dist) && ...); }, dists);
+		if(!dists_found)
+			{ return prng_error_t::DistStateNotFound; }
+
+		Engine = engine;
+		Gauss_dist = gauss;
+		Uni_dist = uni;
+		Dist_set = std::move(dists);
+		Discard_length = static_cast<size_t>(discard);
+		Float_spare = spare.Value;
+		Has_float_spare = spare.Present != 0;
+
+		if(seeds.Flags & 1)
+		{
+			Master_seed = seeds.Master;
+			Stream_id = seeds.Stream;
+			Master_seeded = true;
+			Compact_seeds = (seeds.Flags & 2) != 0;
+			Seed_list = Compact_seeds ? std::vector<result_type>() : this->master_seed_list();
+		}
+		else
+			{ Master_seeded = false; }
+		return prng_error_t::Success;
+		}
+
+	//30
+	/** \brief Save the state of many wrappers to one binary checkpoint file (`checkpoint.hpp`).
+	 * The json state files of `save_state()` remain the portable export format. */
+	static prng_error_t save_checkpoint(const std::string& filename, std::span<PRNGWrapper* const> wrappers) {
+		std::vector<std::vector<std::byte>> records(wrappers.size());
+		for(size_t i = 0; i < wrappers.size(); i++)
+			{ wrappers[i]->snapshot(records[i]); }
+
+		if(!checkpoint_write(filename, layout_tag(), records))
+			{ return prng_error_t::FileError; }
+		return prng_error_t::Success;
+		}
+
+	//31
+	/** \brief Restore many wrappers from a binary checkpoint file. The file is memory-mapped
+	 * and every wrapper is restored with a `memcpy` of its record.
+	 * \attention Returns `FileError` if the file is missing, was written with a different
+	 * layout, or holds fewer records than wrappers passed. */
+	static prng_error_t load_checkpoint(const std::string& filename, std::span<PRNGWrapper* const> wrappers) {
+		CheckpointFile file(filename, layout_tag());
+		if(!file.is_valid() || file.count() < wrappers.size())
+			{ return prng_error_t::FileError; }
+
+		prng_error_t status = prng_error_t::Success;
+		for(size_t i = 0; i < wrappers.size(); i++)
 		{
+			prng_error_t record_status = wrappers[i]->restore(file.record(i));
+			if(record_status != prng_error_t::Success)
+				{ status = record_status; }
+		}
+		return status;
+		}
+
+	//32
+	/** \brief Save the state of this wrapper to a binary checkpoint file. */
+	prng_error_t save_state_binary(const std::string& filename) {
+		PRNGWrapper* self = this;
+		return save_checkpoint(filename, std::span<PRNGWrapper* const>(&self, 1));
+		}
+
+	//33
+	/** \brief Restore the state of this wrapper from record `index` of a binary checkpoint file. */
+	prng_error_t load_state_binary(const std::string& filename, size_t index = 0) {
+		CheckpointFile file(filename, layout_tag());
+		if(!file.is_valid() || index >= file.count())
+			{ return prng_error_t::FileError; }
+		return this->restore(file.record(index));
+		}
+
+	//34
+	/** \brief Save the state of many wrappers to a binary checkpoint file on the writer's
+	 * background thread. Only the in-memory snapshot is taken on the calling thread; the
+	 * serialization, `fsync` and rename happen on the writer (`CheckpointWriter`).
+	 * \return Future that becomes `true` once the file is durably written. */
+	static std::future<bool> save_checkpoint_async(CheckpointWriter& writer, const std::string& filename,
+	                                               std::span<PRNGWrapper* const> wrappers,
+	                                               CheckpointWriter::callback_type callback = nullptr) {
+		std::vector<std::vector<std::byte>> records(wrappers.size());
+		for(size_t i = 0; i < wrappers.size(); i++)
+			{ wrappers[i]->snapshot(records[i]); }
+		return writer.submit(filename, layout_tag(), std::move(records), std::move(callback));
+		}
 
+	//35
+	/** \brief Save the state of this wrapper to a binary checkpoint file in the background.
+	 * The wrapper may be used again as soon as the call returns. */
+	std::future<bool> save_state_async(CheckpointWriter& writer, const std::string& filename,
+	                                   CheckpointWriter::callback_type callback = nullptr) {
+		PRNGWrapper* self = this;
+		return save_checkpoint_async(writer, filename, std::span<PRNGWrapper* const>(&self, 1), std::move(callback));
 		}
 
+	//36
+	/** \brief Draws from distribution `Index` of the distribution set `Dists...`.
+	 * Resolved at compile time, there is no per-draw dispatch. */
+	template <size_t Index>
+	__attribute__((flatten)) typename std::tuple_element_t<Index, dist_set_type>::result_type draw() {
+		PRNGW_COUNT_DIST(Index, 1);
+		return std::get<Index>(Dist_set)(this->Engine);
+		}
 
-		template <size_t SamplesDrawn>
-		double performance(size_t SamplesDrawn, double(*rnd_fnc)())
+	//37
+	/** \brief Draws from the distribution of type `Dist` of the distribution set.
+	 * \attention `Dist` must appear exactly once in `Dists...`. */
+	template <class Dist>
+	__attribute__((flatten)) typename Dist::result_type draw() {
+		PRNGW_COUNT_DIST(dist_index<Dist>(), 1);
+		return std::get<Dist>(Dist_set)(this->Engine);
+		}
+
+	//38
+	/** \brief Fills the passed span with draws from distribution `Index` of the distribution set.
+	 * The stream is identical to repeated calls of `draw<Index>()`. Distributions with a batched
+	 * `generate(engine, span)` path (`ziggurat_normal_distribution`, `alias_discrete_distribution`) use it. */
+	template <size_t Index, typename ResultType>
+	__attribute__((flatten)) void draw_fill(std::span<ResultType> out) {
+		PRNGW_COUNT_DIST(Index, out.size());
+		PRNGW_COUNT(FillCalls, 1);
+		auto& engine = this->Engine;
+		auto& dist = std::get<Index>(Dist_set);
+		if constexpr (requires { dist.generate(engine, out); })
+			{ dist.generate(engine, out); }
+		else
 		{
-			std::array<double, SamplesDrawn> tmp;
+			for(auto& x : out)
+				{ x = static_cast<ResultType>(dist(engine)); }
+		}
+		}
+
+	//39
+	/** \brief Returns distribution `Index` of the distribution set, e.g. to set its parameters. */
+	template <size_t Index>
+	std::tuple_element_t<Index, dist_set_type>& dist() {
+		return std::get<Index>(Dist_set);
+		}
+
+	//40
+	/** \brief Returns the distribution of type `Dist` of the distribution set. */
+	template <class Dist>
+	Dist& dist() {
+		return std::get<Dist>(Dist_set);
+		}
+
+	//41
+	/** \brief Uniformly distributed double drawn with the division-free bits-to-double
+	 * conversion (`fast_uniform.hpp`), scaled to the limits of the uniform distribution.
+	 * \attention The stream differs from `uni()`. Requires a full range 32 or 64-bit Engine. */
+	double uni_fast() __attribute__((flatten)) {
+		PRNGW_COUNT(UniDraws, 1);
+		const double u = fast_uniform(this->Engine);
+		return Uni_dist.a() + (Uni_dist.b() - Uni_dist.a()) * u;
+		}
 
-			using namespace std::chrono;
-			auto start = duration_cast<microseconds>(high_resolution_clock::now().time_since_epoch());
+	//42
+	/** \brief Single precision `uni_fast()`. Every 64-bit word (one draw of a 64-bit Engine, two of a
+	 * 32-bit Engine) gives two floats (`fast_uniform_float2()`); the second is kept for the next
+	 * call, so the stream equals that of `uni_fast_fill()` on `float` spans, in any mix of calls.
+	 * Like the cached value of `std::normal_distribution`, the spare survives reseeding; it is
+	 * saved and restored with the state. */
+	float uni_fast_float() __attribute__((flatten)) {
+		PRNGW_COUNT(UniDraws, 1);
+		float u = Float_spare;
+		if(Has_float_spare)
+			{ Has_float_spare = false; }
+		else
+		{
+			const auto pair = fast_uniform_float2(this->Engine);
+			u = pair.first;
+			Float_spare = pair.second;
+			Has_float_spare = true;
+		}
+		return float(Uni_dist.a()) + float(Uni_dist.b() - Uni_dist.a()) * u;
+		}
 
-			for(size_t i = 0; i < SamplesDrawn; i++)
+	//43
+	/** \brief Fills the passed span with `uni_fast()` numbers. Raw Engine words are drawn in
+	 * blocks and converted with SIMD; `float` spans receive two numbers per 64-bit word and
+	 * give the stream of `uni_fast_float()` (the pending spare first, an odd last word kept as the spare). */
+	template <typename RealType>
+	__attribute__((flatten)) void uni_fast_fill(std::span<RealType> out) {
+		static_assert(std::is_same_v<RealType, double> || std::is_same_v<RealType, float>, "uni_fast_fill() requires a double or float span.");
+		PRNGW_COUNT(UniDraws, out.size());
+		PRNGW_COUNT(FillCalls, 1);
+
+		if constexpr (std::is_same_v<RealType, float>)
+		{
+			size_t begin = 0;
+			if(Has_float_spare && !out.empty())
+			{
+				out[0] = Float_spare;
+				Has_float_spare = false;
+				begin = 1;
+			}
+			const size_t pairs = (out.size() - begin) / 2;
+			fast_uniform_fill(this->Engine, out.subspan(begin, 2 * pairs));
+			if(begin + 2 * pairs < out.size())
 			{
-				tmp = rnd_fnc()
+				const auto pair = fast_uniform_float2(this->Engine);
+				out.back() = pair.first;
+				Float_spare = pair.second;
+				Has_float_spare = true;
 			}
-			auto end = duration_cast<microseconds>(high_resolution_clock::now().time_since_epoch());
+		}
+		else
+			{ fast_uniform_fill(this->Engine, out); }
+		if(Uni_dist.a() != 0.0 || Uni_dist.b() != 1.0)
+		{
+			const RealType lower = RealType(Uni_dist.a());
+			const RealType width = RealType(Uni_dist.b() - Uni_dist.a());
+			for(auto& x : out)
+				{ x = lower + width * x; }
+		}
+		}
+
+	//44
+	/** \brief Unbiased uniform integer in [lo, hi] with Lemire's multiply-shift method: one
+	 * multiplication per draw and a modulo only on the rare rejection path (`fast_uniform.hpp`).
+	 * Signed and unsigned types up to 64 bits, including the full range of the type.
+	 * \attention The stream differs from `std::uniform_int_distribution`. Requires a full range 32 or 64-bit Engine. */
+	template <typename IntType>
+	__attribute__((flatten)) IntType uniform_int(IntType lo, IntType hi) {
+		PRNGW_COUNT(IntDraws, 1);
+		return fast_uniform_int(this->Engine, lo, hi);
+		}
+
+	//45
+	/** \brief Fills the passed span with `uniform_int(lo, hi)` numbers, the same stream as the
+	 * scalar calls. Raw Engine words are drawn in blocks. */
+	template <typename IntType>
+	__attribute__((flatten)) void uniform_int_fill(std::span<IntType> out, IntType lo, IntType hi) {
+		PRNGW_COUNT(IntDraws, out.size());
+		PRNGW_COUNT(FillCalls, 1);
+		fast_uniform_int_fill(this->Engine, out, lo, hi);
+		}
 
-			return (end - start);
+	//46
+	/** \brief Switches the compact seed mode. In compact mode only the 64-bit master seed and
+	 * the stream id of `new_master_seed()` are kept instead of the `state_size` seeds (2.5 KB
+	 * for `std::mt19937`); `get_seedlist()`, `get_first_seed()`, `save_seeds()` and
+	 * `reload_seeds()` re-expand them deterministically and return the same values as
+	 * without compact mode. `new_seeds()` reads a single 64-bit master seed in compact mode.
+	 * Seeds from other sources (single seeds, seed files) are kept in the Seed_list. */
+	void set_compact_seeds(bool enable = true) {
+		Compact_seeds = enable;
+		if(!Master_seeded)
+			{ return; }
+		if(enable)
+			{ std::vector<result_type>().swap(Seed_list); }
+		else
+			{ Seed_list = this->master_seed_list(); }
 		}
 
-		/** @brief Uses the TestU01 suite to evaluate the statistical properties of the random stream and print/returns a summary string.*/
-		void testU01()
+	//47
+	/** \brief True if the seeds are currently held as a master seed and stream id only. */
+	bool compact() const { return Compact_seeds && Master_seeded; }
+	std::uint64_t get_master_seed() const { return Master_seed; }
+	std::uint64_t get_stream_id() const { return Stream_id; }
+
+	//48
+	/** \brief Fills the passed span on `n_threads` threads (0 for all the cores) with exactly
+	 * the numbers of `uni_fill()` and leaves the Engine where `uni_fill()` would, for any number
+	 * of threads. Every uniform double takes a fixed number of Engine words (`canonical_words()`,
+	 * as `std::generate_canonical`), so thread `t` copies the Engine, jumps it (`jump()`: GF(2)
+	 * jump-ahead, counter offsets, ...) to the first word of its contiguous block and fills the
+	 * block; the Engine then takes the state of the last block. A jumped Mersenne Twister is
+	 * stream-equal to the one of `uni_fill()` (same numbers, see `jump()`), but `operator==` may
+	 * report a difference.
+	 * \attention Falls back to `uni_fill()` on the calling thread for small spans and for engines
+	 * that cannot jump. A Mersenne Twister jump costs about 25-35 ms per thread, plus about 0.2 s
+	 * once per process for the characteristic polynomial, hence it pays off for fills of tens of
+	 * millions of numbers; small state and counter-based engines jump in microseconds.
+	 * Assumes a `std::generate_canonical` without retries, as in libstdc++, libc++ and MSVC. */
+	template <typename RealType>
+	void parallel_fill(std::span<RealType> out, size_t n_threads = 0) {
+		static_assert(std::is_floating_point_v<RealType>, "parallel_fill() requires a floating point span.");
+		PRNGW_TIME(ParallelFill);
+
+		if(n_threads == 0)
+			{ n_threads = std::max<size_t>(1, std::thread::hardware_concurrency()); }
+		n_threads = std::min<size_t>(n_threads, out.size() / ParallelFillGrain);
+		if(n_threads <= 1)
 		{
+			this->uni_fill(out);
+			return;
+		}
+
+		constexpr std::uint64_t Words = canonical_words();
+		const size_t n = out.size();
+		PRNGType last = Engine;
+		std::atomic<bool> jumped{true};
 
+		auto worker = [&](size_t t) {
+			const size_t begin = n * t / n_threads;
+			const size_t end = n * (t + 1) / n_threads;
+			PRNGType engine = Engine; //Engine is only read until all the workers are joined
+			if(advance(engine, std::uint64_t(begin) * Words, 0) != prng_error_t::Success)
+			{
+				jumped.store(false, std::memory_order_relaxed);
+				return;
+			}
+			auto dist = Uni_dist;
+			for(size_t i = begin; i < end; i++)
+				{ out[i] = static_cast<RealType>(dist(engine)); }
+			if(t + 1 == n_threads)
+				{ last = engine; }
+		};
+
+		std::vector<std::thread> pool;
+		for(size_t t = 1; t < n_threads; t++)
+			{ pool.emplace_back(worker, t); }
+		worker(0);
+		for(auto& thread : pool)
+			{ thread.join(); }
+
+		if(!jumped.load(std::memory_order_relaxed))
+			{ this->uni_fill(out); }
+		else
+		{
+			Engine = last;
+			PRNGW_COUNT(UniDraws, n);
+			PRNGW_COUNT(FillCalls, 1);
+		}
+		}
+
+	//49
+	/** \brief Engine words per uniform double - `max(1, ceil(53 / floor(log2(R))))` for an Engine
+	 * range `R`, the count of `std::generate_canonical<double, 53>`. */
+	static constexpr std::uint64_t canonical_words() {
+		constexpr unsigned __int128 range = static_cast<unsigned __int128>(PRNGType::max() - PRNGType::min()) + 1;
+		unsigned log2r = 0;
+		while(log2r < 128 && (range >> (log2r + 1)) != 0)
+			{ log2r++; }
+		const std::uint64_t bits = std::numeric_limits<double>::digits;
+		return std::max<std::uint64_t>(1, (bits + log2r - 1) / log2r);
+		}
+
+#ifdef PRNGW_INSTRUMENT
+	//50
+	/** \brief Snapshot of the draw counters and timing histograms of this wrapper (`instrument.hpp`).
+	 * Only with `PRNGW_INSTRUMENT`; may be called from any thread. */
+	PRNGStats stats() const { return Instrument.snapshot(); }
+	void reset_stats() { Instrument.reset(); }
+
+	//51
+	/** \brief Writes `stats()` under `key` at the current level of `yaml`. */
+	void write_stats(YamlFile& yaml, const std::string& key = "prng_stats") const {
+		this->stats().write_yaml(yaml, key);
+		}
+#endif
+
+	class Experimental
+	{
+	public:
+		/** @brief Times `rnd_fnc()` over `samples_drawn` draws per repetition and returns the
+		 * ns/draw statistics (median and percentiles over the repetitions, `bench.hpp`).
+		 * The full benchmark suite of the library is `bench.cpp`. */
+		template <typename Fn>
+		static BenchResult performance(Fn&& rnd_fnc, size_t samples_drawn = size_t(1) << 20, BenchConfig config = {})
+		{
+			return bench_run("performance", samples_drawn, [&]() {
+				for(size_t i = 0; i < samples_drawn; i++)
+					{ do_not_optimize(rnd_fnc()); }
+			}, config);
+		}
+
+		/** @brief Runs the in-library statistical battery (`stat_tests.hpp`) on the Engine
+		 * stream of the wrapper and returns the summary. Every test runs on its own thread
+		 * over an independent chunk - chunk `i` is a copy of the Engine advanced by
+		 * `(i + 1) * 2^StreamShift` numbers. The wrapper itself is not advanced.
+		 * \attention Engines without jump-ahead are tested on reseeded copies instead, which
+		 * tests the engine and the seeding, but not one contiguous stream. */
+		static StatReport testU01(const PRNGWrapper& wrapper, StatConfig config = {})
+		{
+			return stat_battery([&wrapper](size_t chunk) {
+				PRNGType engine = wrapper.Engine;
+				if(advance(engine, chunk + 1, StreamShift) != prng_error_t::Success)
+				{
+					SplitMix64 mix{(std::uint64_t(engine()) << 32) ^ (chunk + 1)};
+					std::vector<std::uint32_t> seeds(PRNGType::state_size);
+					for(auto& seed : seeds)
+						{ seed = static_cast<std::uint32_t>(mix()); }
+					std::seed_seq seq(seeds.begin(), seeds.end());
+					engine.seed(seq);
+				}
+				return engine;
+			}, config);
 		}
 
 		/** @brief Alias of `testU01()` function.*/
-		void stat_analysis() __attribute__((weak, alias("testU01")));
+		static StatReport stat_analysis(const PRNGWrapper& wrapper, StatConfig config = {})
+		{
+			return testU01(wrapper, config);
+		}
 
 	};
 
 private:
 //Helper Functions
 
+	/** \brief Uniform random bit generator over `get_nondet()`, for `gauss_nondet()` and `uni_nondet()`. */
+	struct NondetSource
+	{
+		using result_type = typename PRNGWrapper::result_type;
+		PRNGWrapper& Wrapper;
+		static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+		static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+		result_type operator()() { return Wrapper.get_nondet(); }
+	};
+
+	/** \brief Master seed of the binary checkpoint records. */
+	struct SeedRecord
+	{
+		std::uint64_t Master = 0;
+		std::uint64_t Stream = 0;
+		std::uint64_t Flags = 0; //!< Bit 0 - master seeded, bit 1 - compact
+	};
+
+	/** \brief Pending float of the fast uniform stream, as stored in the binary checkpoints. */
+	struct SpareRecord
+	{
+		float Value = 0.0f;
+		std::uint32_t Present = 0;
+	};
+
+	/** \brief Expands the master seed into the `state_size` seeds of `new_master_seed()`. */
+	std::vector<result_type> master_seed_list() const {
+		std::vector<result_type> seeds(PRNGType::state_size);
+		SplitMix64 mix{Master_seed};
+		for(auto& seed : seeds)
+			{ seed = static_cast<result_type>(mix()); }
+		return seeds;
+		}
+
+	/** \brief Returns the text state of every distribution of the distribution set. */
+	std::vector<std::string> dist_set_text() const {
+		std::vector<std::string> text;
+		auto put = [&text](const auto& dist) {
+			std::ostringstream ss;
+			ss << dist;
+			text.push_back(ss.str());
+		};
+		std::apply([&put](const auto&... dist) { (put(dist), ...); }, Dist_set);
+		return text;
+		}
+
+	/** \brief Restores the distribution set from the text states of `dist_set_text()`.
+	 * The distribution set is left unchanged if any state is missing or invalid. */
+	bool load_dist_set_text(const std::vector<std::string>& text) {
+		if(text.size() != sizeof...(Dists))
+			{ return false; }
+
+		dist_set_type dists;
+		size_t i = 0;
+		auto get = [&text, &i](auto& dist) {
+			std::istringstream ss(text[i++]);
+			ss >> dist;
+			return !ss.fail();
+		};
+		const bool ok = std::apply([&get](auto&... dist) { return (get(dist) && ...); }, dists);
+		if(ok)
+			{ Dist_set = std::move(dists); }
+		return ok;
+		}
+
+#ifdef PRNGW_INSTRUMENT
+	/** \brief Index of `Dist` in the distribution set, for the per-distribution counters. */
+	template <class Dist>
+	static constexpr size_t dist_index() {
+		size_t index = 0;
+		((std::is_same_v<Dist, Dists> ? false : (++index, true)) && ...);
+		return index;
+		}
+#endif
+
+	/** \brief Advances `engine` by `distance * 2^shift` numbers, see `jump()`. */
+	static prng_error_t advance(PRNGType& engine, std::uint64_t distance, unsigned shift) {
+		
+		if constexpr (is_mersenne_twister_v<PRNGType>)
+		{
+			if(!mt_jump(engine, distance, shift))
+				{ return prng_error_t::JumpUnsupported; }
+		}
+
+		else if constexpr (requires { { engine.jump(distance, shift) } -> std::same_as<bool>; })
+		{
+			if(!engine.jump(distance, shift))
+				{ return prng_error_t::JumpUnsupported; }
+		}
+
+		else if constexpr (requires { engine.jump(distance, shift); })
+			{ engine.jump(distance, shift); }
+
+		else
+		{
+			if(shift >= 64 || distance > (~std::uint64_t(0) >> shift))
+				{ return prng_error_t::JumpUnsupported; }
+			engine.discard(distance << shift);
+		}
+
+		return prng_error_t::Success;
+		}
+
 	/** \brief Checks whether the file has a given extension extension. */
-	bool has_ext(std::string filename, sts::string ext) const {
-		return bool(filename.substr(filename.find_last_of(".") + 1) == ext);
+	static bool has_ext(const std::string& filename, std::string_view ext) {
+		const size_t dot = filename.find_last_of('.');
+		return dot != std::string::npos && std::string_view(filename).substr(dot + 1) == ext;
+		}
+
+	/** \brief Text state of an engine or a distribution (`operator<<`), the json state format. */
+	template <class Object>
+	static std::string text_state(const Object& object) {
+		std::ostringstream ss;
+		ss << object;
+		return ss.str();
+		}
+
+	/** \brief Reads `object` from its json text state into a fresh object, which is moved into
+	 * `object` on success; `object` is unchanged on failure. */
+	template <class Object>
+	static bool from_text(const nlohmann::json& text, Object& object) {
+		if(!text.is_string())
+			{ return false; }
+		std::istringstream ss(text.template get<std::string>());
+		Object tmp;
+		ss >> tmp;
+		if(ss.fail())
+			{ return false; }
+		object = std::move(tmp);
+		return true;
 		}
 
 	/** \brief Returns the seeding status based on the size of the Seed_list. */
 	prng_error_t seed_status() const {
-		if(Seed_list.size() == 0)
+		if(this->compact())
+			return prng_error_t::Success;
+		else if(Seed_list.size() == 0)
 			return prng_error_t::SeedNotFound;
-		else if(Seed_list.size() < Engine::state_size)
+		else if(Seed_list.size() < PRNGType::state_size)
 			return prng_error_t::EntropyShortage;
 		else
 			return prng_error_t::Success;
 		}
-};
\ No newline at end of file
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#ifndef PRNGW_CACHE_LINE
+	#define PRNGW_CACHE_LINE 64 //!< Alignment used to keep per-thread objects on separate cache lines
+#endif
+
+
+/** @brief Counts `items` items into `histogram` on `threads` threads (0 for all the cores).
+ * Thread `t` owns a cache-line aligned partial histogram and counts the items
+ * [items * t / threads, items * (t + 1) / threads) into it with `count(t, partial, begin, end)`;
+ * the partials are merged once all the threads finish, so the threads never share a cache line
+ * while counting. The share of every thread is fixed, hence the result is reproducible when
+ * every thread draws from its own stream (e.g. `PRNGPool::get(t)`).
+ *  Hist - Histogram with `reset()` and `merge()`; the partials are copies of `histogram`.
+ * @param count Callable `void(size_t thread, Hist& partial, std::uint64_t begin, std::uint64_t end)`, called concurrently. */
+template <class Hist, class CountFn>
+void parallel_partials(Hist& histogram, std::uint64_t items, size_t threads, CountFn&& count)
+{
+	struct alignas(PRNGW_CACHE_LINE) Partial
+	{
+		Hist H;
+	};
+
+	if(threads == 0)
+		{ threads = std::max<size_t>(1, std::thread::hardware_concurrency()); }
+
+	std::vector<Partial> partials(threads, Partial{histogram});
+	for(auto& p : partials)
+		{ p.H.reset(); }
+
+	auto worker = [&](size_t t) {
+		count(t, partials[t].H, items * t / threads, items * (t + 1) / threads);
+	};
+
+	std::vector<std::thread> pool;
+	for(size_t t = 1; t < threads; t++)
+		{ pool.emplace_back(worker, t); }
+	worker(0);
+	for(auto& thread : pool)
+		{ thread.join(); }
+
+	for(const auto& p : partials)
+		{ histogram.merge(p.H); }
+}
@@ -1,7 +1,20 @@
+#pragma once
+
+#include "parallel.hpp"
+
 #include <iostream>
 #include <sstream>
-
-std::string hist_gen()
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <span>
+#include <thread>
+#include <numeric>
+#include <algorithm>
+#include <type_traits>
+
+inline std::string hist_gen()
 {
 	unsigned int cols = 10;
 	unsigned int cols_margin = 4;
@@ -44,47 +57,150 @@ std::string hist_gen()
 	}
 
 	std::cout << "Histogram\n" << buffer.str() << std::endl;
-
+	return buffer.str();
 }
 
-void reload_state()
+inline void reload_state()
 {
 	return;
 }
 
-void sample(sample_fn, std::uint64_t samples=100000)
+
+/** @brief Histogram of `double` samples over [Lower, Upper) with equal width bins.
+ * The bin count is a template parameter (`Bins > 0`, counts live inside the object) for
+ * fixed layouts, or a constructor argument (`Bins == 0`, counts on the heap) for ad-hoc use.
+ * Samples outside the range are counted in `underflow()`/`overflow()`. Counts are 64-bit. */
+template <size_t Bins = 0>
+class Histogram
 {
-	
-	//verify that bins is a multiple of 10.
+	using storage_type = std::conditional_t<(Bins > 0), std::array<std::uint64_t, Bins>, std::vector<std::uint64_t>>;
+
+	double Lower; //!< Lower edge of the first bin
+	double Upper; //!< Upper edge of the last bin
+	double Scale; //!< Bins per unit
+	storage_type Counts; //!< Bin counts
+	std::uint64_t Underflow = 0; //!< Samples below `Lower` (and NaNs)
+	std::uint64_t Overflow = 0; //!< Samples at or above `Upper`
+
+public:
+
+	//0
+	/** @brief Constructor -> Compile-time bins. */
+	Histogram(double lower, double upper) requires (Bins > 0):
+		Lower(lower), Upper(upper), Scale(double(Bins) / (upper - lower)), Counts{}
+	{}
+
+	/** @brief Constructor -> Runtime bins. */
+	Histogram(double lower, double upper, size_t bins) requires (Bins == 0):
+		Lower(lower), Upper(upper), Scale(double(bins) / (upper - lower)), Counts(bins, 0)
+	{}
+
+	//1
+	/** @brief Adds one sample. Out-of-range samples are rejected before the conversion to a
+	 * bin index, which is undefined for infinities and values beyond `size_t`. */
+	inline void add(double x) __attribute__((always_inline)) {
+		if(!(x >= Lower))
+			{ Underflow++; return; }
+		if(!(x < Upper))
+			{ Overflow++; return; }
+		const size_t bin = static_cast<size_t>((x - Lower) * Scale);
+		if(bin >= Counts.size()) //Rounding just below Upper
+			{ Overflow++; return; }
+		Counts[bin]++;
+		}
 
+	//2
+	/** @brief Adds a block of samples. */
+	void add(std::span<const double> xs) __attribute__((flatten)) {
+		for(double x : xs)
+			{ add(x); }
+		}
 
-	//Allocate memory
-	std::uint64_t count_hist[bins] = {0};
-	double hist[bins] = {0.0};
+	//3
+	/** @brief Adds the counts of another histogram with the same layout. */
+	void merge(const Histogram& other) {
+		for(size_t i = 0; i < Counts.size(); i++)
+			{ Counts[i] += other.Counts[i]; }
+		Underflow += other.Underflow;
+		Overflow += other.Overflow;
+		}
 
-	//Draw random number and generate rt histogram
-	double roll = 0;
-	for(std::uint64_t i = 0; i < samples; i++)
-	{
-		roll = this->sample_fn();
-		count_hist[unsigned int(round(p*bins))]++;
-	}
+	//4
+	/** @brief Clears all the counts. */
+	void reset() {
+		std::fill(Counts.begin(), Counts.end(), 0);
+		Underflow = 0;
+		Overflow = 0;
+		}
 
-	for (auto i : count_hist) { std::cout << i << std::endl;} //DEBUG
+	//5
+	size_t bins() const { return Counts.size(); }
+	std::uint64_t count(size_t bin) const { return Counts[bin]; }
+	std::uint64_t underflow() const { return Underflow; }
+	std::uint64_t overflow() const { return Overflow; }
+	const storage_type& counts() const { return Counts; }
 
+	/** @brief Lower edge of `bin`, `edge(bins())` is the upper edge of the last bin. */
+	double edge(size_t bin) const { return Lower + double(bin) / Scale; }
 
-	//Normalization
-	std::uint64_t max_count = *std::max_element(count_hist, count_hist+bins);
-	for(unsigned int i = 0; i < bins; i++)
-	{
-		hist[i] = count_hist[i] * max_cols/max_count;
-	}
+	/** @brief Number of samples, including the ones outside the range. */
+	std::uint64_t total() const {
+		return std::accumulate(Counts.begin(), Counts.end(), std::uint64_t(0)) + Underflow + Overflow;
+		}
 
+	//6
+	/** @brief Probability density estimate of every bin (count / (total * width)). */
+	std::vector<double> density() const {
+		std::vector<double> d(Counts.size(), 0.0);
+		const std::uint64_t n = total();
+		if(n == 0)
+			{ return d; }
+		for(size_t i = 0; i < Counts.size(); i++)
+			{ d[i] = double(Counts[i]) * Scale / double(n); }
+		return d;
+		}
+};
 
-	// Reload state
-	reload_state();
 
+/** @brief Fills a histogram with `samples` draws on `threads` threads (0 for all the cores),
+ * see `parallel_partials()`. Every thread draws blocks of samples with `draw(t, block)`,
+ * which must fill the whole span, e.g. `PRNGPool::get(t).uni_fill(block)`.
+ * @param histogram Empty histogram with the requested layout, receives the counts.
+ * @param draw Callable `void(size_t thread, std::span<double> block)`, called concurrently.
+ * @param samples Number of samples. */
+template <size_t Bins, class DrawFn>
+void sample_parallel(Histogram<Bins>& histogram, DrawFn&& draw, std::uint64_t samples, size_t threads = 0)
+{
+	constexpr size_t BlockSize = 4096; //!< Samples per `draw` call, fits in L1
 
-	//Return hist
-	return hist;
+	parallel_partials(histogram, samples, threads, [&](size_t t, Histogram<Bins>& h, std::uint64_t begin, std::uint64_t end) {
+		std::vector<double> block(BlockSize);
+		for(std::uint64_t i = begin; i < end; i += BlockSize)
+		{
+			const size_t n = static_cast<size_t>(std::min<std::uint64_t>(BlockSize, end - i));
+			std::span<double> out(block.data(), n);
+			draw(t, out);
+			h.add(std::span<const double>(out));
+		}
+	});
+}
+
+
+/** @brief Samples a distribution into a histogram with compile-time bins over [lower, upper).
+ * See `sample_parallel()` for the `draw(thread, block)` callback. */
+template <size_t Bins, class DrawFn>
+Histogram<Bins> sample(DrawFn&& draw, std::uint64_t samples, double lower, double upper, size_t threads = 0)
+{
+	Histogram<Bins> histogram(lower, upper);
+	sample_parallel(histogram, std::forward<DrawFn>(draw), samples, threads);
+	return histogram;
+}
+
+/** @brief Samples a distribution into a histogram with `bins` runtime bins over [lower, upper). */
+template <class DrawFn>
+Histogram<> sample(DrawFn&& draw, std::uint64_t samples, double lower, double upper, size_t bins, size_t threads = 0)
+{
+	Histogram<> histogram(lower, upper, bins);
+	sample_parallel(histogram, std::forward<DrawFn>(draw), samples, threads);
+	return histogram;
 }
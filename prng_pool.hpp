@@ -0,0 +1,129 @@
+#pragma once
+
+#include "new_wrapper.hpp"
+#include "parallel.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+
+
+/** @brief Pool of `PRNGWrapper` streams derived from one master seed. Stream `i` is the
+ * master state advanced by `i * 2^StreamShift` numbers (`PRNGWrapper::new_master_seed()`),
+ * hence the streams never overlap and a given master seed always gives the same streams,
+ * independent of the number of threads or the order in which the streams are requested.
+ * Streams are built lazily by the thread that first asks for them, so the start-up cost is
+ * spread over the threads instead of being paid serially, and every stream is cache-line
+ * aligned so that threads drawing from neighbouring streams do not share cache lines.
+ * The streams use the compact seed mode - only the master seed and the stream index are kept.
+ *  PRNGType - PRNG Engine, must jump by 2^StreamShift (`has_stream_jump_v`: Mersenne Twister,
+ *  counter-based, xoshiro256, pcg64 - not wyrand).
+ *  GaussDist - Gaussian distribution of the wrappers (optional).
+ *  Dists - Additional distributions of the wrappers (optional). */
+template <class PRNGType, class GaussDist = std::normal_distribution<double>, class... Dists>
+class PRNGPool
+{
+	static_assert(has_stream_jump_v<PRNGType>,
+	              "PRNGPool requires an engine that jumps by 2^StreamShift to guarantee non-overlapping streams.");
+
+public:
+
+	using wrapper_type = PRNGWrapper<PRNGType, 0, GaussDist, Dists...>; //!< Wrapper handed to the threads
+
+private:
+
+	/** @brief One stream, padded to its own cache lines. */
+	struct alignas(PRNGW_CACHE_LINE) Slot
+	{
+		std::once_flag Built; //!< Set once the stream has been seeded
+		wrapper_type Wrapper; //!< Stream
+	};
+
+	std::uint64_t MasterSeed; //!< Master seed of all the streams
+	size_t Size; //!< Number of streams
+	std::unique_ptr<Slot[]> Slots; //!< Streams
+	std::atomic<size_t> NextLocal; //!< Next stream handed out by `local()`
+	std::uint64_t Id; //!< Unique id of the pool, used by the thread-local lookup
+
+public:
+
+	//0
+	/** @brief Constructor -> Allocates (but does not seed) `streams` streams.
+	 * @param master_seed Master seed shared by all the streams.
+	 * @param streams Maximum number of streams. */
+	PRNGPool(std::uint64_t master_seed, size_t streams):
+		MasterSeed(master_seed), Size(streams), Slots(new Slot[streams]), NextLocal(0), Id(next_id())
+	{}
+
+	PRNGPool(const PRNGPool&) = delete;
+	PRNGPool& operator=(const PRNGPool&) = delete;
+
+	//1
+	/** @brief Returns stream `index`. The stream is seeded on first access.
+	 * \attention `index` must be smaller than `size()`. Every stream must be used by one thread at a time.
+	 * Throws `std::runtime_error` if the stream cannot be seeded (the jump to it failed); the
+	 * stream is then seeded again on the next access. */
+	wrapper_type& get(size_t index) {
+		Slot& slot = Slots[index];
+		std::call_once(slot.Built, [&]() {
+			slot.Wrapper.set_compact_seeds(true);
+			if(slot.Wrapper.new_master_seed(MasterSeed, index) != wrapper_type::Success)
+				{ throw std::runtime_error("PRNGPool: cannot jump to stream " + std::to_string(index)); }
+		});
+		return slot.Wrapper;
+		}
+
+	//2
+	/** @brief Returns the stream owned by the calling thread. Every thread that calls
+	 * `local()` is assigned the next free stream on its first call.
+	 * \attention Returns `nullptr` once all the streams have been handed out. Which thread
+	 * receives which stream depends on the call order; use `get()` with an explicit index
+	 * when results must not depend on thread scheduling.
+	 * Every thread keeps one small entry (pool id, stream index) per pool it called `local()`
+	 * on, until the thread exits; entries of destroyed pools are not removed, but never match
+	 * a later pool since ids are not reused. */
+	wrapper_type* local() {
+		struct LocalEntry
+		{
+			std::uint64_t PoolId;
+			size_t Index;
+		};
+		thread_local std::vector<LocalEntry> entries; //One entry per pool used by the thread
+
+		for(const auto& entry : entries)
+		{
+			if(entry.PoolId == Id)
+				{ return &get(entry.Index); }
+		}
+
+		const size_t index = NextLocal.fetch_add(1, std::memory_order_relaxed);
+		if(index >= Size)
+			{ return nullptr; }
+		entries.push_back({Id, index});
+		return &get(index);
+		}
+
+	//3
+	/** @brief Returns the number of streams. */
+	size_t size() const { return Size; }
+
+	//4
+	/** @brief Returns the master seed. */
+	std::uint64_t master_seed() const { return MasterSeed; }
+
+private:
+//Helper Functions
+
+	/** @brief Returns an id unique within the process, so that thread-local entries of a
+	 * destroyed pool never match a new pool allocated at the same address. */
+	static std::uint64_t next_id() {
+		static std::atomic<std::uint64_t> counter{0};
+		return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+		}
+};
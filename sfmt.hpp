@@ -0,0 +1,298 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array>
+#include <span>
+#include <limits>
+#include <istream>
+#include <ostream>
+
+#if defined(__SSE2__)
+	#include <emmintrin.h>
+#endif
+
+//Reference - "SIMD-oriented Fast Mersenne Twister: a 128-bit Pseudorandom Number Generator", M. Saito, M. Matsumoto in Monte Carlo and Quasi-Monte Carlo Methods 2006, Springer 2008, Pages 607-622
+
+
+/** @brief SIMD-oriented Fast Mersenne Twister (SFMT19937) engine that satisfies the
+ * `UniformRandomBitGenerator` concept and can be passed as the `PRNGType` of `PRNGWrapper`.
+ * The state is 156 128-bit words (period 2^19937 - 1, same as `std::mt19937`) that are
+ * regenerated in one block with SSE2 when available and a portable fallback otherwise.
+ * Both paths produce the same stream as the reference implementation. */
+class sfmt19937
+{
+public:
+
+	using result_type = std::uint32_t; //!< Output type of the engine
+
+	static constexpr size_t word_size = 32; //!< Number of bits in every output
+	static constexpr size_t state_size = 624; //!< Number of 32-bit words in the state (N32)
+	static constexpr result_type default_seed = 5489u; //!< Seed used by the default constructor
+
+private:
+
+	static constexpr size_t N = state_size / 4; //!< Number of 128-bit words in the state
+	static constexpr size_t Pos1 = 122;
+	static constexpr int SL1 = 18;
+	static constexpr int SL2 = 1;
+	static constexpr int SR1 = 11;
+	static constexpr int SR2 = 1;
+	static constexpr std::array<std::uint32_t, 4> Mask = {0xdfffffefU, 0xddfecb7fU, 0xbffaffffU, 0xbffffff6U};
+	static constexpr std::array<std::uint32_t, 4> Parity = {0x00000001U, 0x00000000U, 0x00000000U, 0x13c9e684U};
+
+	alignas(16) std::array<std::uint32_t, state_size> State; //!< Internal state
+	size_t Index; //!< Index of the next output within the state
+
+public:
+
+	//0
+	/** @brief Constructor -> Seeds the engine with `default_seed`. */
+	sfmt19937() { seed(default_seed); }
+
+	/** @brief Constructor -> Seeds the engine with a single seed. */
+	explicit sfmt19937(result_type x_seed) { seed(x_seed); }
+
+	/** @brief Constructor -> Seeds the engine with a seed sequence. */
+	template <class SeedSeq, typename = decltype(std::declval<SeedSeq&>().generate(std::declval<std::uint32_t*>(), std::declval<std::uint32_t*>()))>
+	explicit sfmt19937(SeedSeq& seq) { seed(seq); }
+
+	//1
+	/** @brief Smallest value returned by the engine. */
+	static constexpr result_type min() { return 0; }
+
+	//2
+	/** @brief Largest value returned by the engine. */
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+	//3
+	/** @brief Seed the engine with a single value (`init_gen_rand` of the reference). */
+	void seed(result_type x_seed = default_seed) {
+		State[0] = x_seed;
+		for(size_t i = 1; i < state_size; i++)
+		{
+			State[i] = 1812433253U * (State[i - 1] ^ (State[i - 1] >> 30)) + static_cast<std::uint32_t>(i);
+		}
+		period_certification();
+		Index = state_size;
+		}
+
+	//4
+	/** @brief Seed the full state of the engine from a seed sequence (`std::seed_seq` or compatible). */
+	template <class SeedSeq>
+	auto seed(SeedSeq& seq) -> decltype(seq.generate(std::declval<std::uint32_t*>(), std::declval<std::uint32_t*>()), void()) {
+		seq.generate(State.begin(), State.end());
+		period_certification();
+		Index = state_size;
+		}
+
+	//5
+	/** @brief Returns the next 32-bit random number. */
+	result_type inline operator()() __attribute__((always_inline)) {
+		if(Index >= state_size)
+		{
+			gen_rand_all();
+			Index = 0;
+		}
+		return State[Index++];
+		}
+
+	//6
+	/** @brief Advances the engine by `z` outputs. Whole blocks are regenerated without being read. */
+	void discard(unsigned long long z) {
+		while(z > 0)
+		{
+			if(Index >= state_size)
+			{
+				gen_rand_all();
+				Index = 0;
+			}
+			size_t step = state_size - Index;
+			if(z < step)
+				{ step = static_cast<size_t>(z); }
+			Index += step;
+			z -= step;
+		}
+		}
+
+	//7
+	/** @brief Bulk generation entry point. Fills the span with the same numbers that
+	 * repeated calls of `operator()` would return. Whole state blocks are copied with
+	 * `memcpy` instead of being returned one word at a time. */
+	void generate(std::span<result_type> out) {
+		size_t filled = 0;
+		const size_t size = out.size();
+
+		while(filled < size)
+		{
+			if(Index >= state_size)
+			{
+				gen_rand_all();
+				Index = 0;
+			}
+			size_t step = state_size - Index;
+			if(size - filled < step)
+				{ step = size - filled; }
+			std::memcpy(out.data() + filled, State.data() + Index, step * sizeof(result_type));
+			Index += step;
+			filled += step;
+		}
+		}
+
+	/** @brief Engines compare equal if their future streams are equal. */
+	friend bool operator==(const sfmt19937& lhs, const sfmt19937& rhs) {
+		return lhs.Index == rhs.Index && lhs.State == rhs.State;
+		}
+
+	/** @brief Writes the engine state (state words followed by the index) as text. */
+	template <class CharT, class Traits>
+	friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const sfmt19937& engine) {
+		const auto flags = os.flags();
+		const CharT space = os.widen(' ');
+		os.flags(std::ios_base::dec | std::ios_base::left);
+		os.fill(space);
+
+		for(size_t i = 0; i < state_size; i++)
+			{ os << engine.State[i] << space; }
+		os << engine.Index;
+
+		os.flags(flags);
+		return os;
+		}
+
+	/** @brief Reads the engine state written by `operator<<`. */
+	template <class CharT, class Traits>
+	friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, sfmt19937& engine) {
+		const auto flags = is.flags();
+		is.flags(std::ios_base::dec | std::ios_base::skipws);
+
+		sfmt19937 tmp;
+		for(size_t i = 0; i < state_size; i++)
+			{ is >> tmp.State[i]; }
+		is >> tmp.Index;
+
+		if(!is.fail() && tmp.Index <= state_size)
+			{ engine = tmp; }
+		else
+			{ is.setstate(std::ios_base::failbit); }
+
+		is.flags(flags);
+		return is;
+		}
+
+private:
+//Helper Functions
+
+	/** @brief Makes sure that the state is not in the small sub-period of the recursion. */
+	void period_certification() {
+		std::uint32_t inner = 0;
+		for(size_t i = 0; i < 4; i++)
+			{ inner ^= State[i] & Parity[i]; }
+		for(int i = 16; i > 0; i >>= 1)
+			{ inner ^= inner >> i; }
+
+		if(inner & 1)
+			{ return; }
+
+		for(size_t i = 0; i < 4; i++)
+		{
+			std::uint32_t work = 1;
+			for(size_t j = 0; j < 32; j++)
+			{
+				if(work & Parity[i])
+				{
+					State[i] ^= work;
+					return;
+				}
+				work <<= 1;
+			}
+		}
+		}
+
+#if defined(__SSE2__)
+
+	/** @brief SSE2 recursion over one 128-bit word. */
+	static inline __m128i do_recursion(__m128i a, __m128i b, __m128i c, __m128i d, __m128i mask) __attribute__((always_inline)) {
+		__m128i x = _mm_slli_si128(a, SL2);
+		__m128i y = _mm_srli_epi32(b, SR1);
+		__m128i z = _mm_srli_si128(c, SR2);
+		__m128i v = _mm_slli_epi32(d, SL1);
+		z = _mm_xor_si128(z, a);
+		z = _mm_xor_si128(z, v);
+		y = _mm_and_si128(y, mask);
+		z = _mm_xor_si128(z, x);
+		return _mm_xor_si128(z, y);
+		}
+
+	/** @brief Regenerates the whole state with SSE2. */
+	void gen_rand_all() {
+		__m128i* state = reinterpret_cast<__m128i*>(State.data());
+		const __m128i mask = _mm_set_epi32(Mask[3], Mask[2], Mask[1], Mask[0]);
+
+		__m128i r1 = _mm_load_si128(state + N - 2);
+		__m128i r2 = _mm_load_si128(state + N - 1);
+		size_t i = 0;
+		for(; i < N - Pos1; i++)
+		{
+			__m128i r = do_recursion(_mm_load_si128(state + i), _mm_load_si128(state + i + Pos1), r1, r2, mask);
+			_mm_store_si128(state + i, r);
+			r1 = r2;
+			r2 = r;
+		}
+		for(; i < N; i++)
+		{
+			__m128i r = do_recursion(_mm_load_si128(state + i), _mm_load_si128(state + i + Pos1 - N), r1, r2, mask);
+			_mm_store_si128(state + i, r);
+			r1 = r2;
+			r2 = r;
+		}
+		}
+
+#else
+
+	/** @brief Portable recursion over one 128-bit word stored as four 32-bit lanes. */
+	static inline void do_recursion(std::uint32_t* r, const std::uint32_t* a, const std::uint32_t* b,
+	                                const std::uint32_t* c, const std::uint32_t* d) __attribute__((always_inline)) {
+		const std::uint64_t ah = (std::uint64_t(a[3]) << 32) | a[2];
+		const std::uint64_t al = (std::uint64_t(a[1]) << 32) | a[0];
+		const std::uint64_t xh = (ah << (SL2 * 8)) | (al >> (64 - SL2 * 8));
+		const std::uint64_t xl = al << (SL2 * 8);
+
+		const std::uint64_t ch = (std::uint64_t(c[3]) << 32) | c[2];
+		const std::uint64_t cl = (std::uint64_t(c[1]) << 32) | c[0];
+		const std::uint64_t yh = ch >> (SR2 * 8);
+		const std::uint64_t yl = (cl >> (SR2 * 8)) | (ch << (64 - SR2 * 8));
+
+		const std::uint32_t x[4] = {std::uint32_t(xl), std::uint32_t(xl >> 32), std::uint32_t(xh), std::uint32_t(xh >> 32)};
+		const std::uint32_t y[4] = {std::uint32_t(yl), std::uint32_t(yl >> 32), std::uint32_t(yh), std::uint32_t(yh >> 32)};
+
+		for(size_t k = 0; k < 4; k++)
+		{
+			r[k] = a[k] ^ x[k] ^ ((b[k] >> SR1) & Mask[k]) ^ y[k] ^ (d[k] << SL1);
+		}
+		}
+
+	/** @brief Regenerates the whole state with the portable recursion. */
+	void gen_rand_all() {
+		std::uint32_t* state = State.data();
+		const std::uint32_t* r1 = state + 4 * (N - 2);
+		const std::uint32_t* r2 = state + 4 * (N - 1);
+		size_t i = 0;
+		for(; i < N - Pos1; i++)
+		{
+			do_recursion(state + 4 * i, state + 4 * i, state + 4 * (i + Pos1), r1, r2);
+			r1 = r2;
+			r2 = state + 4 * i;
+		}
+		for(; i < N; i++)
+		{
+			do_recursion(state + 4 * i, state + 4 * i, state + 4 * (i + Pos1 - N), r1, r2);
+			r1 = r2;
+			r2 = state + 4 * i;
+		}
+		}
+
+#endif
+
+};
@@ -0,0 +1,532 @@
+#pragma once
+
+#include "gf2_poly.hpp"
+#include "splitmix.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <limits>
+#include <utility>
+#include <istream>
+#include <ostream>
+
+//Reference - "Scrambled Linear Pseudorandom Number Generators", D. Blackman, S. Vigna in ACM Transactions on Mathematical Software Volume 47 Issue 4, 2021 Article 36
+//Reference - "PCG: A Family of Simple Fast Space-Efficient Statistically Good Algorithms for Random Number Generation", M. E. O'Neill, HMC-CS-2014-0905, 2014
+//Reference - "wyhash and wyrand", Wang Yi, https://github.com/wangyi-fudan/wyhash
+
+
+/** @brief Small state 64-bit engines that satisfy the `UniformRandomBitGenerator` concept and
+ * can be passed as the `PRNGType` of `PRNGWrapper`. The state is 32 bytes (xoshiro256, pcg64)
+ * or 8 bytes (wyrand) instead of the 2.5 KB of `std::mt19937`, and the objects are trivially
+ * copyable, hence binary checkpoints are a `memcpy`.
+ *
+ * `state_size` is the number of 32-bit seed words that fill the state, since `PRNGWrapper`
+ * seeds through `std::seed_seq`, which keeps 32 bits of every seed. Every engine has
+ * `jump(distance, shift)`: xoshiro256 with GF(2) polynomial jump-ahead, pcg64 with LCG
+ * jump-ahead and wyrand by moving its counter. */
+
+
+/** @brief Output function of xoshiro256** - `rotl(s1 * 5, 7) * 9`. All bits are of full quality. */
+struct Xoshiro256StarStar
+{
+	static inline std::uint64_t output(const std::array<std::uint64_t, 4>& s) __attribute__((always_inline)) {
+		const std::uint64_t x = s[1] * 5;
+		return ((x << 7) | (x >> 57)) * 9;
+		}
+};
+
+/** @brief Output function of xoshiro256+ - `s0 + s3`. Slightly faster; the lowest bits have low
+ * linear complexity, which does not matter for floating point conversion (top 53 bits). */
+struct Xoshiro256Plus
+{
+	static inline std::uint64_t output(const std::array<std::uint64_t, 4>& s) __attribute__((always_inline)) {
+		return s[0] + s[3];
+		}
+};
+
+
+/** @brief xoshiro256 engine with the output function `Scrambler`. Period 2^256 - 1.
+ * `jump()` and `long_jump()` advance by 2^128 and 2^192 outputs with the published polynomials;
+ * `jump(distance, shift)` computes `x^(distance 2^shift) mod P` for the characteristic polynomial
+ * `P` of the state transition (computed once per process) and costs the same for any distance. */
+template <class Scrambler>
+class xoshiro256_engine
+{
+public:
+
+	using result_type = std::uint64_t; //!< Output type of the engine
+	using state_type = std::array<std::uint64_t, 4>; //!< State words
+
+	static constexpr size_t word_size = 64; //!< Number of bits in every output
+	static constexpr size_t state_size = 8; //!< Number of 32-bit seed words
+	static constexpr result_type default_seed = 0x9E3779B97F4A7C15ULL; //!< Seed used by the default constructor
+
+	/** @brief Distances below this are cheaper with `discard()`. */
+	static constexpr unsigned long long discard_threshold = 1ULL << 10;
+
+private:
+
+	state_type S; //!< State, never all zero
+
+public:
+
+	//0
+	/** @brief Constructor -> Seeds the engine with `default_seed`. */
+	xoshiro256_engine() { seed(default_seed); }
+
+	/** @brief Constructor -> Seeds the engine with a single seed. */
+	explicit xoshiro256_engine(result_type x_seed) { seed(x_seed); }
+
+	/** @brief Constructor -> Sets the state. An all zero state is replaced by the default seed. */
+	explicit xoshiro256_engine(const state_type& state) { set_state(state); }
+
+	/** @brief Constructor -> Seeds the engine with a seed sequence. */
+	template <class SeedSeq, typename = decltype(std::declval<SeedSeq&>().generate(std::declval<std::uint32_t*>(), std::declval<std::uint32_t*>()))>
+	explicit xoshiro256_engine(SeedSeq& seq) { seed(seq); }
+
+	//1
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+	//2
+	/** @brief Expands a single seed into the state with SplitMix64, as recommended by the authors. */
+	void seed(result_type x_seed = default_seed) {
+		SplitMix64 mix{x_seed};
+		for(auto& s : S)
+			{ s = mix(); }
+		}
+
+	//3
+	/** @brief Fills the state from `state_size` words of a seed sequence. */
+	template <class SeedSeq>
+	auto seed(SeedSeq& seq) -> decltype(seq.generate(std::declval<std::uint32_t*>(), std::declval<std::uint32_t*>()), void()) {
+		std::array<std::uint32_t, state_size> words;
+		seq.generate(words.begin(), words.end());
+		state_type state;
+		for(size_t i = 0; i < 4; i++)
+			{ state[i] = (std::uint64_t(words[2 * i + 1]) << 32) | words[2 * i]; }
+		set_state(state);
+		}
+
+	//4
+	/** @brief Returns the next 64-bit random number. */
+	result_type inline operator()() __attribute__((always_inline)) {
+		const result_type result = Scrambler::output(S);
+		step(S);
+		return result;
+		}
+
+	//5
+	/** @brief Advances the engine by `z` outputs, with a jump polynomial for long distances. */
+	void discard(unsigned long long z) {
+		if(z < discard_threshold)
+		{
+			for(; z > 0; z--)
+				{ step(S); }
+		}
+		else
+			{ apply(modulus().x_pow(z)); }
+		}
+
+	//6
+	/** @brief Advances the engine by `distance * 2^shift` outputs (modulo the period). */
+	void jump(std::uint64_t distance, unsigned shift = 0) {
+		if(shift == 0)
+			{ discard(distance); }
+		else if(distance != 0)
+			{ apply(modulus().x_pow(distance, shift)); }
+		}
+
+	/** @brief Advances the engine by 2^128 outputs - 2^128 non-overlapping streams. */
+	void jump() {
+		static constexpr std::uint64_t Jump[4] = {0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL};
+		apply(Jump);
+		}
+
+	/** @brief Advances the engine by 2^192 outputs - 2^64 starting points of `jump()` streams. */
+	void long_jump() {
+		static constexpr std::uint64_t LongJump[4] = {0x76E15D3EFEFDCBBFULL, 0xC5004E441C522FB3ULL, 0x77710069854EE241ULL, 0x39109BB02ACBE635ULL};
+		apply(LongJump);
+		}
+
+	//7
+	state_type state() const { return S; }
+
+	/** @brief Sets the state. An all zero state is replaced by the default seed. */
+	void set_state(const state_type& state) {
+		S = state;
+		if((S[0] | S[1] | S[2] | S[3]) == 0)
+			{ seed(default_seed); }
+		}
+
+	/** @brief Engines compare equal if their states are equal. */
+	friend bool operator==(const xoshiro256_engine& lhs, const xoshiro256_engine& rhs) {
+		return lhs.S == rhs.S;
+		}
+
+	/** @brief Writes the engine state (four words) as text. */
+	template <class CharT, class Traits>
+	friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const xoshiro256_engine& engine) {
+		const auto flags = os.flags();
+		os.flags(std::ios_base::dec | std::ios_base::left);
+		os << engine.S[0] << os.widen(' ') << engine.S[1] << os.widen(' ') << engine.S[2] << os.widen(' ') << engine.S[3];
+		os.flags(flags);
+		return os;
+		}
+
+	/** @brief Reads the engine state written by `operator<<`. */
+	template <class CharT, class Traits>
+	friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, xoshiro256_engine& engine) {
+		const auto flags = is.flags();
+		is.flags(std::ios_base::dec | std::ios_base::skipws);
+
+		state_type state;
+		if(is >> state[0] >> state[1] >> state[2] >> state[3])
+		{
+			if((state[0] | state[1] | state[2] | state[3]) != 0)
+				{ engine.S = state; }
+			else
+				{ is.setstate(std::ios_base::failbit); }
+		}
+
+		is.flags(flags);
+		return is;
+		}
+
+private:
+//Helper Functions
+
+	/** @brief State transition (linear over GF(2)). */
+	static inline void step(state_type& s) __attribute__((always_inline)) {
+		const std::uint64_t t = s[1] << 17;
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= t;
+		s[3] = (s[3] << 45) | (s[3] >> 19);
+		}
+
+	/** @brief Replaces the state by `q(T) state` for the jump polynomial `q` (coefficient `i` is bit `i`). */
+	void apply(const std::uint64_t* q, size_t words = 4) {
+		state_type result = {0, 0, 0, 0};
+		for(size_t w = 0; w < words; w++)
+		{
+			for(unsigned b = 0; b < 64; b++)
+			{
+				if((q[w] >> b) & 1)
+				{
+					for(size_t i = 0; i < 4; i++)
+						{ result[i] ^= S[i]; }
+				}
+				step(S);
+			}
+		}
+		S = result;
+		}
+
+	void apply(const GF2Poly& q) {
+		std::uint64_t words[4] = {0, 0, 0, 0};
+		for(size_t w = 0; w < 4 && w < q.Words.size(); w++)
+			{ words[w] = q.Words[w]; }
+		apply(words);
+		}
+
+	/** @brief Returns the cached modulus (characteristic polynomial of the state transition). */
+	static const GF2Modulus& modulus() {
+		static const GF2Modulus mod(characteristic_polynomial());
+		return mod;
+		}
+
+	/** @brief Characteristic polynomial from 2 x 256 bits of one state bit (Berlekamp-Massey). */
+	static GF2Poly characteristic_polynomial() {
+		state_type s = {1, 2, 3, 4};
+		std::vector<std::uint8_t> bits(2 * 256);
+		for(auto& bit : bits)
+		{
+			bit = s[0] & 1;
+			step(s);
+		}
+		return berlekamp_massey(bits);
+		}
+};
+
+using xoshiro256starstar = xoshiro256_engine<Xoshiro256StarStar>; //!< xoshiro256** engine
+using xoshiro256plus = xoshiro256_engine<Xoshiro256Plus>; //!< xoshiro256+ engine
+
+
+/** @brief PCG64 (XSL RR 128/64): a 128-bit LCG with a selectable stream (odd increment) and a
+ * xorshift-low / random-rotation output. The stream matches `pcg64` of the PCG reference library.
+ * Period 2^128 per stream; `discard()` and `jump()` use LCG jump-ahead in O(log distance). */
+class pcg64
+{
+public:
+
+	using result_type = std::uint64_t; //!< Output type of the engine
+	using uint128 = unsigned __int128;
+
+	static constexpr size_t word_size = 64; //!< Number of bits in every output
+	static constexpr size_t state_size = 8; //!< Number of 32-bit seed words (4 state, 4 stream)
+	static constexpr result_type default_seed = 0xCAFEF00DD15EA5E5ULL; //!< Seed used by the default constructor
+
+	static constexpr uint128 Multiplier = (uint128(0x2360ED051FC65DA4ULL) << 64) | 0x4385DF649FCCF645ULL;
+	static constexpr uint128 DefaultIncrement = (uint128(0x5851F42D4C957F2DULL) << 64) | 0x14057B7EF767814FULL;
+
+private:
+
+	uint128 State; //!< LCG state
+	uint128 Increment; //!< Odd increment, selects the stream
+
+public:
+
+	//0
+	/** @brief Constructor -> Seeds the engine with `default_seed` on the default stream. */
+	pcg64() { seed(default_seed); }
+
+	/** @brief Constructor -> Seeds the engine with a single seed on the default stream. */
+	explicit pcg64(result_type x_seed) { seed(x_seed); }
+
+	/** @brief Constructor -> Seeds the engine with a seed on stream `stream`. */
+	pcg64(uint128 x_seed, uint128 stream) { seed(x_seed, stream); }
+
+	/** @brief Constructor -> Seeds the engine with a seed sequence. */
+	template <class SeedSeq, typename = decltype(std::declval<SeedSeq&>().generate(std::declval<std::uint32_t*>(), std::declval<std::uint32_t*>()))>
+	explicit pcg64(SeedSeq& seq) { seed(seq); }
+
+	//1
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+	//2
+	/** @brief Seeds the state on the default stream. */
+	void seed(result_type x_seed = default_seed) {
+		Increment = DefaultIncrement;
+		init(x_seed);
+		}
+
+	/** @brief Seeds the state on stream `stream` (the increment is `2 stream + 1`). */
+	void seed(uint128 x_seed, uint128 stream) {
+		Increment = (stream << 1) | 1;
+		init(x_seed);
+		}
+
+	//3
+	/** @brief Fills the seed (first 4 words) and the stream (last 4 words) from a seed sequence. */
+	template <class SeedSeq>
+	auto seed(SeedSeq& seq) -> decltype(seq.generate(std::declval<std::uint32_t*>(), std::declval<std::uint32_t*>()), void()) {
+		std::array<std::uint32_t, state_size> words;
+		seq.generate(words.begin(), words.end());
+		uint128 x_seed = 0, stream = 0;
+		for(size_t i = 4; i-- > 0; )
+		{
+			x_seed = (x_seed << 32) | words[i];
+			stream = (stream << 32) | words[4 + i];
+		}
+		seed(x_seed, stream);
+		}
+
+	//4
+	/** @brief Returns the next 64-bit random number. */
+	result_type inline operator()() __attribute__((always_inline)) {
+		State = State * Multiplier + Increment;
+		const std::uint64_t x = std::uint64_t(State >> 64) ^ std::uint64_t(State);
+		const unsigned rot = unsigned(State >> 122);
+		return (x >> rot) | (x << ((64 - rot) & 63));
+		}
+
+	//5
+	/** @brief Advances the engine by `z` outputs in O(log z). */
+	void discard(unsigned long long z) {
+		advance(uint128(z));
+		}
+
+	//6
+	/** @brief Advances the engine by `distance * 2^shift` outputs (modulo the period 2^128). */
+	void jump(std::uint64_t distance, unsigned shift = 0) {
+		if(shift < 128)
+			{ advance(uint128(distance) << shift); }
+		}
+
+	//7
+	uint128 state() const { return State; }
+	uint128 increment() const { return Increment; }
+
+	/** @brief Engines compare equal if their states and streams are equal. */
+	friend bool operator==(const pcg64& lhs, const pcg64& rhs) {
+		return lhs.State == rhs.State && lhs.Increment == rhs.Increment;
+		}
+
+	/** @brief Writes the engine state (state and increment as high/low words) as text. */
+	template <class CharT, class Traits>
+	friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const pcg64& engine) {
+		const auto flags = os.flags();
+		const CharT space = os.widen(' ');
+		os.flags(std::ios_base::dec | std::ios_base::left);
+		os << std::uint64_t(engine.State >> 64) << space << std::uint64_t(engine.State) << space
+		   << std::uint64_t(engine.Increment >> 64) << space << std::uint64_t(engine.Increment);
+		os.flags(flags);
+		return os;
+		}
+
+	/** @brief Reads the engine state written by `operator<<`. */
+	template <class CharT, class Traits>
+	friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, pcg64& engine) {
+		const auto flags = is.flags();
+		is.flags(std::ios_base::dec | std::ios_base::skipws);
+
+		std::uint64_t w[4];
+		if(is >> w[0] >> w[1] >> w[2] >> w[3])
+		{
+			if(w[3] & 1)
+			{
+				engine.State = (uint128(w[0]) << 64) | w[1];
+				engine.Increment = (uint128(w[2]) << 64) | w[3];
+			}
+			else
+				{ is.setstate(std::ios_base::failbit); }
+		}
+
+		is.flags(flags);
+		return is;
+		}
+
+private:
+//Helper Functions
+
+	/** @brief Seeding of the reference library: two steps around the addition of the seed. */
+	void init(uint128 x_seed) {
+		State = 0;
+		State = State * Multiplier + Increment;
+		State += x_seed;
+		State = State * Multiplier + Increment;
+		}
+
+	/** @brief LCG jump-ahead (F. Brown, "Random Number Generation with Arbitrary Stride", 1994). */
+	void advance(uint128 delta) {
+		uint128 acc_mult = 1, acc_plus = 0;
+		uint128 cur_mult = Multiplier, cur_plus = Increment;
+		while(delta > 0)
+		{
+			if(delta & 1)
+			{
+				acc_mult *= cur_mult;
+				acc_plus = acc_plus * cur_mult + cur_plus;
+			}
+			cur_plus = (cur_mult + 1) * cur_plus;
+			cur_mult *= cur_mult;
+			delta >>= 1;
+		}
+		State = acc_mult * State + acc_plus;
+		}
+};
+
+
+/** @brief wyrand: a 64-bit counter (Weyl sequence) hashed with a 64x64 -> 128-bit multiply.
+ * 8 bytes of state and one multiplication per output; the fastest engine here. The counter
+ * makes `discard()` and `jump()` O(1), but the period is only 2^64.
+ * \attention `jump()` returns false (and leaves the engine unchanged) for distances of 2^64
+ * and beyond, which would wrap around the period; streams of `PRNGWrapper::new_master_seed()`
+ * are 2^64 long, hence wyrand streams must be separated by their seeds, and `PRNGPool` and
+ * `AsyncPRNG` do not accept wyrand (`has_stream_jump_v`). */
+class wyrand
+{
+public:
+
+	using result_type = std::uint64_t; //!< Output type of the engine
+
+	static constexpr size_t word_size = 64; //!< Number of bits in every output
+	static constexpr size_t state_size = 2; //!< Number of 32-bit seed words
+	static constexpr result_type default_seed = 0x243F6A8885A308D3ULL; //!< Seed used by the default constructor
+
+	static constexpr std::uint64_t Increment = 0xA0761D6478BD642FULL;
+	static constexpr std::uint64_t Mix = 0xE7037ED1A0B428DBULL;
+
+private:
+
+	std::uint64_t State; //!< Counter
+
+public:
+
+	//0
+	/** @brief Constructor -> Seeds the engine with `default_seed`. */
+	wyrand() { seed(default_seed); }
+
+	/** @brief Constructor -> Seeds the engine with a single seed. */
+	explicit wyrand(result_type x_seed) { seed(x_seed); }
+
+	/** @brief Constructor -> Seeds the engine with a seed sequence. */
+	template <class SeedSeq, typename = decltype(std::declval<SeedSeq&>().generate(std::declval<std::uint32_t*>(), std::declval<std::uint32_t*>()))>
+	explicit wyrand(SeedSeq& seq) { seed(seq); }
+
+	//1
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+	//2
+	/** @brief The seed is the counter. */
+	void seed(result_type x_seed = default_seed) { State = x_seed; }
+
+	//3
+	/** @brief Fills the counter from two words of a seed sequence. */
+	template <class SeedSeq>
+	auto seed(SeedSeq& seq) -> decltype(seq.generate(std::declval<std::uint32_t*>(), std::declval<std::uint32_t*>()), void()) {
+		std::array<std::uint32_t, state_size> words;
+		seq.generate(words.begin(), words.end());
+		State = (std::uint64_t(words[1]) << 32) | words[0];
+		}
+
+	//4
+	/** @brief Returns the next 64-bit random number. */
+	result_type inline operator()() __attribute__((always_inline)) {
+		State += Increment;
+		const unsigned __int128 m = static_cast<unsigned __int128>(State) * (State ^ Mix);
+		return std::uint64_t(m) ^ std::uint64_t(m >> 64);
+		}
+
+	//5
+	/** @brief Advances the engine by `z` outputs in constant time. */
+	void discard(unsigned long long z) { State += Increment * std::uint64_t(z); }
+
+	//6
+	/** @brief Advances the engine by `distance * 2^shift` outputs in constant time.
+	 * Returns false for distances of 2^64 and beyond (a full period or more). */
+	bool jump(std::uint64_t distance, unsigned shift = 0) {
+		if(distance == 0)
+			{ return true; }
+		if(shift >= 64 || distance > (~std::uint64_t(0) >> shift))
+			{ return false; }
+		discard(distance << shift);
+		return true;
+		}
+
+	//7
+	std::uint64_t state() const { return State; }
+
+	friend bool operator==(const wyrand& lhs, const wyrand& rhs) {
+		return lhs.State == rhs.State;
+		}
+
+	/** @brief Writes the engine state (the counter) as text. */
+	template <class CharT, class Traits>
+	friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const wyrand& engine) {
+		const auto flags = os.flags();
+		os.flags(std::ios_base::dec | std::ios_base::left);
+		os << engine.State;
+		os.flags(flags);
+		return os;
+		}
+
+	/** @brief Reads the engine state written by `operator<<`. */
+	template <class CharT, class Traits>
+	friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, wyrand& engine) {
+		const auto flags = is.flags();
+		is.flags(std::ios_base::dec | std::ios_base::skipws);
+		std::uint64_t state;
+		if(is >> state)
+			{ engine.State = state; }
+		is.flags(flags);
+		return is;
+		}
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+//Reference - "Fast Splittable Pseudorandom Number Generators", G. L. Steele Jr., D. Lea, C. H. Flood in OOPSLA '14 Proceedings, 2014 Pages 453-472
+
+
+/** @brief SplitMix64 generator. Used to expand a single 64-bit master seed into the full
+ * seed sequence of an engine - every 64-bit seed gives a distinct, well mixed sequence. */
+struct SplitMix64
+{
+	std::uint64_t State; //!< Current state
+
+	/** @brief Returns the next 64-bit number. */
+	std::uint64_t inline operator()() __attribute__((always_inline))
+	{
+		std::uint64_t z = (State += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+};
@@ -0,0 +1,494 @@
+#pragma once
+
+#include "gf2_poly.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <ostream>
+#include <iomanip>
+
+//References -
+//"The Art of Computer Programming Vol. 2, Seminumerical Algorithms", D. Knuth, Section 3.3.2 (gap, collision, serial tests)
+//"DIEHARD: a battery of tests of randomness", G. Marsaglia, 1995 (birthday spacings, binary rank)
+//"A Statistical Test Suite for Random and Pseudorandom Number Generators", NIST SP 800-22 Rev. 1a, 2010 (frequency, runs, linear complexity)
+
+
+/** @brief Settings of the statistical battery. */
+struct StatConfig
+{
+	size_t Scale = 1; //!< Multiplies the sample size of every test (1 takes a few seconds per test)
+	double Alpha = 0.001; //!< A test fails if its p-value lies outside [Alpha, 1 - Alpha]
+	size_t Threads = 0; //!< Worker threads, 0 for `std::thread::hardware_concurrency()`
+};
+
+/** @brief Outcome of one statistical test. */
+struct StatTestResult
+{
+	std::string Name; //!< Test name and parameters
+	double Statistic = 0.0; //!< Test statistic (chi-square, count, ...)
+	double PValue = 0.0; //!< p-value of the statistic
+	bool Passed = false; //!< p-value inside [Alpha, 1 - Alpha]
+	double Seconds = 0.0; //!< Run time of the test
+};
+
+/** @brief Results of the battery. */
+struct StatReport
+{
+	std::vector<StatTestResult> Results; //!< One entry per test, in battery order
+	double Seconds = 0.0; //!< Wall time of the battery
+
+	size_t passed() const {
+		return size_t(std::count_if(Results.begin(), Results.end(), [](const StatTestResult& r) { return r.Passed; }));
+		}
+
+	bool all_passed() const { return passed() == Results.size(); }
+
+	friend std::ostream& operator<<(std::ostream& os, const StatReport& report) {
+		const auto flags = os.flags();
+		os << std::left << std::setw(40) << "test" << std::right << std::setw(16) << "statistic"
+		   << std::setw(14) << "p-value" << std::setw(10) << "time[s]" << "  result\n";
+		for(const auto& r : report.Results)
+		{
+			os << std::left << std::setw(40) << r.Name << std::right
+			   << std::setw(16) << std::setprecision(6) << r.Statistic
+			   << std::setw(14) << std::setprecision(4) << r.PValue
+			   << std::setw(10) << std::fixed << std::setprecision(2) << r.Seconds << std::defaultfloat
+			   << "  " << (r.Passed ? "pass" : "FAIL") << '\n';
+		}
+		os << "Summary: " << report.passed() << "/" << report.Results.size() << " tests passed in "
+		   << std::fixed << std::setprecision(2) << report.Seconds << " s\n";
+		os.flags(flags);
+		return os;
+		}
+};
+
+
+namespace stat_detail
+{
+
+/** @brief Regularized lower incomplete gamma function `P(a, x)`. */
+inline double gamma_p(double a, double x)
+{
+	if(x <= 0.0)
+		{ return 0.0; }
+	const double log_prefix = a * std::log(x) - x - std::lgamma(a);
+
+	if(x < a + 1.0) //Series
+	{
+		double term = 1.0 / a;
+		double sum = term;
+		for(int n = 1; n < 100000; n++)
+		{
+			term *= x / (a + n);
+			sum += term;
+			if(std::fabs(term) < std::fabs(sum) * 1e-15)
+				{ break; }
+		}
+		return std::min(1.0, sum * std::exp(log_prefix));
+	}
+
+	//Continued fraction (modified Lentz) for Q, P = 1 - Q
+	const double tiny = 1e-300;
+	double b = x + 1.0 - a;
+	double c = 1.0 / tiny;
+	double d = 1.0 / b;
+	double h = d;
+	for(int n = 1; n < 100000; n++)
+	{
+		const double an = -n * (n - a);
+		b += 2.0;
+		d = an * d + b;
+		if(std::fabs(d) < tiny) { d = tiny; }
+		c = b + an / c;
+		if(std::fabs(c) < tiny) { c = tiny; }
+		d = 1.0 / d;
+		const double delta = d * c;
+		h *= delta;
+		if(std::fabs(delta - 1.0) < 1e-15)
+			{ break; }
+	}
+	return std::max(0.0, 1.0 - std::exp(log_prefix) * h);
+}
+
+/** @brief Regularized upper incomplete gamma function `Q(a, x) = 1 - P(a, x)`. */
+inline double gamma_q(double a, double x)
+{
+	return 1.0 - gamma_p(a, x);
+}
+
+/** @brief Right tail p-value of a chi-square statistic with `dof` degrees of freedom. */
+inline double chi2_pvalue(double chi2, double dof)
+{
+	return gamma_q(dof / 2.0, chi2 / 2.0);
+}
+
+/** @brief Right tail `P(X >= k)` of a Poisson variable with mean `lambda`. */
+inline double poisson_right(std::uint64_t k, double lambda)
+{
+	if(k == 0)
+		{ return 1.0; }
+	return gamma_p(double(k), lambda);
+}
+
+/** @brief Chi-square statistic of observed counts against expected probabilities. */
+inline double chi2_statistic(const std::vector<std::uint64_t>& observed, const std::vector<double>& probs, double total)
+{
+	double chi2 = 0.0;
+	for(size_t i = 0; i < observed.size(); i++)
+	{
+		const double expected = total * probs[i];
+		const double diff = double(observed[i]) - expected;
+		chi2 += diff * diff / expected;
+	}
+	return chi2;
+}
+
+
+/** @brief Draws full range 32-bit words from an engine. 64-bit engines give two words per draw. */
+template <class Engine>
+class Words32
+{
+	using result_type = typename Engine::result_type;
+	static constexpr bool wide = Engine::max() == std::numeric_limits<std::uint64_t>::max();
+
+	static_assert(Engine::min() == 0 && (Engine::max() == std::numeric_limits<std::uint32_t>::max() || wide),
+	              "The statistical tests require an engine with a full 32-bit or 64-bit output range.");
+
+	Engine& E;
+	std::uint32_t Spare = 0;
+	bool HasSpare = false;
+
+public:
+	explicit Words32(Engine& engine): E(engine) {}
+
+	inline std::uint32_t operator()() __attribute__((always_inline)) {
+		if constexpr (wide)
+		{
+			if(HasSpare)
+			{
+				HasSpare = false;
+				return Spare;
+			}
+			const std::uint64_t x = E();
+			Spare = std::uint32_t(x);
+			HasSpare = true;
+			return std::uint32_t(x >> 32);
+		}
+		else
+			{ return std::uint32_t(E()); }
+		}
+
+	/** @brief Uniform double in [0, 1) from one word. */
+	inline double uniform() __attribute__((always_inline)) {
+		return (*this)() * (1.0 / 4294967296.0);
+		}
+};
+
+/** @brief Rank over GF(2) of a 32 x 32 bit matrix, one row per word. */
+inline unsigned rank32(std::array<std::uint32_t, 32> rows)
+{
+	unsigned rank = 0;
+	for(unsigned bit = 0; bit < 32 && rank < 32; bit++)
+	{
+		const std::uint32_t mask = std::uint32_t(1) << (31 - bit);
+		size_t pivot = rank;
+		while(pivot < 32 && !(rows[pivot] & mask))
+			{ pivot++; }
+		if(pivot == 32)
+			{ continue; }
+		std::swap(rows[rank], rows[pivot]);
+		for(size_t r = 0; r < 32; r++)
+		{
+			if(r != rank && (rows[r] & mask))
+				{ rows[r] ^= rows[rank]; }
+		}
+		rank++;
+	}
+	return rank;
+}
+
+} //End of namespace stat_detail
+
+
+/** @brief The tests of the battery. Every test draws from its own engine and returns its result.
+ * Sample sizes are given for `Scale = 1`. */
+namespace stat_tests
+{
+
+using namespace stat_detail;
+
+/** @brief Frequency (monobit) test, 2^25 bits - the proportion of ones. */
+template <class Engine>
+StatTestResult frequency(Engine& engine, size_t scale)
+{
+	Words32<Engine> words(engine);
+	const std::uint64_t n_words = (std::uint64_t(1) << 20) * scale;
+	std::int64_t ones = 0;
+	for(std::uint64_t i = 0; i < n_words; i++)
+		{ ones += std::popcount(words()); }
+
+	const double n = double(n_words) * 32.0;
+	const double s = std::fabs(2.0 * double(ones) - n);
+	return {"frequency (monobit)", s / std::sqrt(n), std::erfc(s / std::sqrt(2.0 * n))};
+}
+
+/** @brief Runs test, 2^25 bits - the number of runs of identical bits. */
+template <class Engine>
+StatTestResult runs(Engine& engine, size_t scale)
+{
+	Words32<Engine> words(engine);
+	const std::uint64_t n_words = (std::uint64_t(1) << 20) * scale;
+	std::uint64_t ones = 0;
+	std::uint64_t transitions = 0;
+	std::uint32_t last_bit = 0;
+	for(std::uint64_t i = 0; i < n_words; i++)
+	{
+		const std::uint32_t w = words();
+		ones += std::popcount(w);
+		transitions += std::popcount((w ^ (w >> 1)) & 0x7FFFFFFFU); //Within the word, MSB first
+		if(i > 0)
+			{ transitions += (w >> 31) ^ last_bit; }
+		last_bit = w & 1;
+	}
+
+	const double n = double(n_words) * 32.0;
+	const double pi = double(ones) / n;
+	const double v = double(transitions) + 1.0;
+	const double num = std::fabs(v - 2.0 * n * pi * (1.0 - pi));
+	const double den = 2.0 * std::sqrt(2.0 * n) * pi * (1.0 - pi);
+	return {"runs", v, std::erfc(num / den)};
+}
+
+/** @brief Serial test, 2^22 non-overlapping pairs in 64 x 64 cells. */
+template <class Engine>
+StatTestResult serial(Engine& engine, size_t scale)
+{
+	Words32<Engine> words(engine);
+	const std::uint64_t pairs = (std::uint64_t(1) << 22) * scale;
+	std::vector<std::uint64_t> cells(64 * 64, 0);
+	for(std::uint64_t i = 0; i < pairs; i++)
+	{
+		const std::uint32_t a = words() >> 26;
+		const std::uint32_t b = words() >> 26;
+		cells[a * 64 + b]++;
+	}
+
+	const std::vector<double> probs(cells.size(), 1.0 / double(cells.size()));
+	const double chi2 = chi2_statistic(cells, probs, double(pairs));
+	return {"serial (64 x 64 pairs)", chi2, chi2_pvalue(chi2, double(cells.size() - 1))};
+}
+
+/** @brief Gap test, 2^18 gaps between visits of [0, 1/4), gap lengths 0 ... 23 and >= 24. */
+template <class Engine>
+StatTestResult gap(Engine& engine, size_t scale)
+{
+	Words32<Engine> words(engine);
+	constexpr size_t t = 24;
+	constexpr double p = 0.25;
+	const std::uint64_t n_gaps = (std::uint64_t(1) << 18) * scale;
+
+	std::vector<std::uint64_t> counts(t + 1, 0);
+	for(std::uint64_t g = 0; g < n_gaps; g++)
+	{
+		size_t length = 0;
+		while(words.uniform() >= p)
+			{ length++; }
+		counts[std::min(length, t)]++;
+	}
+
+	std::vector<double> probs(t + 1);
+	for(size_t r = 0; r < t; r++)
+		{ probs[r] = p * std::pow(1.0 - p, double(r)); }
+	probs[t] = std::pow(1.0 - p, double(t));
+
+	const double chi2 = chi2_statistic(counts, probs, double(n_gaps));
+	return {"gap ([0, 1/4), t = 24)", chi2, chi2_pvalue(chi2, double(t))};
+}
+
+/** @brief Birthday spacings test, 2^12 birthdays in a year of 2^32 days, 1000 repetitions.
+ * The number of repeated spacings is Poisson with mean 4 per repetition.
+ * \attention The Poisson mean is asymptotic and about 0.3% high for these parameters,
+ * which starts to dominate the statistical error for `Scale` beyond a few hundred. */
+template <class Engine>
+StatTestResult birthday_spacings(Engine& engine, size_t scale)
+{
+	Words32<Engine> words(engine);
+	constexpr size_t m = 4096;
+	constexpr double days = 4294967296.0;
+	const size_t reps = 1000 * scale;
+
+	std::vector<std::uint32_t> birthdays(m);
+	std::uint64_t collisions = 0;
+	for(size_t rep = 0; rep < reps; rep++)
+	{
+		for(auto& b : birthdays)
+			{ b = words(); }
+		std::sort(birthdays.begin(), birthdays.end());
+		for(size_t i = m - 1; i > 0; i--)
+			{ birthdays[i] -= birthdays[i - 1]; }
+		std::sort(birthdays.begin(), birthdays.end());
+		for(size_t i = 1; i < m; i++)
+			{ collisions += (birthdays[i] == birthdays[i - 1]); }
+	}
+
+	const double lambda = double(reps) * double(m) * double(m) * double(m) / (4.0 * days);
+	return {"birthday spacings (2^12 in 2^32)", double(collisions), poisson_right(collisions, lambda)};
+}
+
+/** @brief Collision test, 2^14 balls in 2^20 urns, 200 repetitions. The total number of
+ * collisions is approximately Poisson. */
+template <class Engine>
+StatTestResult collision(Engine& engine, size_t scale)
+{
+	Words32<Engine> words(engine);
+	constexpr size_t urns = size_t(1) << 20;
+	constexpr size_t balls = size_t(1) << 14;
+	const size_t reps = 200 * scale;
+
+	std::vector<std::uint64_t> occupied(urns / 64);
+	std::uint64_t collisions = 0;
+	for(size_t rep = 0; rep < reps; rep++)
+	{
+		std::fill(occupied.begin(), occupied.end(), 0);
+		for(size_t b = 0; b < balls; b++)
+		{
+			const std::uint32_t urn = words() >> 12;
+			const std::uint64_t bit = std::uint64_t(1) << (urn % 64);
+			collisions += (occupied[urn / 64] & bit) != 0;
+			occupied[urn / 64] |= bit;
+		}
+	}
+
+	const double k = double(urns);
+	const double per_rep = double(balls) - k + k * std::pow(1.0 - 1.0 / k, double(balls));
+	return {"collision (2^14 in 2^20)", double(collisions), poisson_right(collisions, per_rep * double(reps))};
+}
+
+/** @brief Binary rank test, 2^14 random 32 x 32 matrices, ranks 32, 31 and <= 30. */
+template <class Engine>
+StatTestResult matrix_rank(Engine& engine, size_t scale)
+{
+	Words32<Engine> words(engine);
+	const std::uint64_t n = (std::uint64_t(1) << 14) * scale;
+
+	std::vector<std::uint64_t> counts(3, 0);
+	std::array<std::uint32_t, 32> rows;
+	for(std::uint64_t i = 0; i < n; i++)
+	{
+		for(auto& row : rows)
+			{ row = words(); }
+		const unsigned rank = rank32(rows);
+		counts[rank == 32 ? 0 : (rank == 31 ? 1 : 2)]++;
+	}
+
+	const std::vector<double> probs = {0.2887880950866024, 0.5775761901732048, 0.1336357147401928};
+	const double chi2 = chi2_statistic(counts, probs, double(n));
+	return {"matrix rank (32 x 32)", chi2, chi2_pvalue(chi2, 2.0)};
+}
+
+/** @brief Linear complexity test, 2^11 blocks of 500 bits. The linear complexity of every
+ * block is computed with Berlekamp-Massey (`gf2_poly.hpp`). */
+template <class Engine>
+StatTestResult linear_complexity(Engine& engine, size_t scale)
+{
+	Words32<Engine> words(engine);
+	constexpr size_t M = 500;
+	const size_t blocks = 2048 * scale;
+
+	//Mean linear complexity of a random block of M bits (M even)
+	const double mu = M / 2.0 + 8.0 / 36.0 - (M / 3.0 + 2.0 / 9.0) / std::pow(2.0, double(M));
+
+	std::vector<std::uint64_t> counts(7, 0);
+	std::vector<std::uint8_t> bits(M);
+	std::uint32_t w = 0;
+	unsigned left = 0;
+	for(size_t b = 0; b < blocks; b++)
+	{
+		for(auto& bit : bits)
+		{
+			if(left == 0)
+			{
+				w = words();
+				left = 32;
+			}
+			bit = (w >> --left) & 1;
+		}
+		const double L = double(berlekamp_massey(bits).degree());
+		const double T = (L - mu) + 2.0 / 9.0;
+		const long category = std::lround(std::clamp(T, -3.0, 3.0)) + 3;
+		counts[size_t(category)]++;
+	}
+
+	const std::vector<double> probs = {0.010417, 0.03125, 0.125, 0.5, 0.25, 0.0625, 0.020833};
+	const double chi2 = chi2_statistic(counts, probs, double(blocks));
+	return {"linear complexity (M = 500)", chi2, chi2_pvalue(chi2, 6.0)};
+}
+
+} //End of namespace stat_tests
+
+
+/** @brief Runs the battery. Every test runs on a worker thread with its own engine, obtained
+ * from `make_engine(chunk)` - chunk `i` must be an independent part of the stream under test
+ * (e.g. the engine advanced by `i` substreams). With enough cores all the tests run at once
+ * and the battery takes as long as its slowest test.
+ * @param make_engine Callable `Engine(size_t chunk)`, called on the worker threads.
+ * @param config Sample size scale, significance and number of threads. */
+template <class MakeEngine>
+StatReport stat_battery(MakeEngine&& make_engine, StatConfig config = {})
+{
+	using Engine = decltype(make_engine(size_t(0)));
+	using Test = StatTestResult (*)(Engine&, size_t);
+
+	static constexpr Test tests[] = {
+		&stat_tests::linear_complexity<Engine>, //Slowest first
+		&stat_tests::birthday_spacings<Engine>,
+		&stat_tests::collision<Engine>,
+		&stat_tests::matrix_rank<Engine>,
+		&stat_tests::serial<Engine>,
+		&stat_tests::gap<Engine>,
+		&stat_tests::frequency<Engine>,
+		&stat_tests::runs<Engine>,
+	};
+	constexpr size_t n_tests = sizeof(tests) / sizeof(tests[0]);
+
+	using clock = std::chrono::steady_clock;
+	const auto start = clock::now();
+
+	StatReport report;
+	report.Results.resize(n_tests);
+	std::atomic<size_t> next{0};
+
+	auto worker = [&]() {
+		for(size_t i = next.fetch_add(1); i < n_tests; i = next.fetch_add(1))
+		{
+			const auto t0 = clock::now();
+			Engine engine = make_engine(i);
+			StatTestResult result = tests[i](engine, config.Scale == 0 ? 1 : config.Scale);
+			result.Passed = result.PValue >= config.Alpha && result.PValue <= 1.0 - config.Alpha;
+			result.Seconds = std::chrono::duration<double>(clock::now() - t0).count();
+			report.Results[i] = result;
+		}
+	};
+
+	size_t n_threads = config.Threads != 0 ? config.Threads : std::thread::hardware_concurrency();
+	n_threads = std::clamp<size_t>(n_threads, 1, n_tests);
+	std::vector<std::thread> threads;
+	for(size_t t = 1; t < n_threads; t++)
+		{ threads.emplace_back(worker); }
+	worker();
+	for(auto& thread : threads)
+		{ thread.join(); }
+
+	report.Seconds = std::chrono::duration<double>(clock::now() - start).count();
+	return report;
+}
@@ -1,10 +1,1047 @@
 #include "plot.hpp"
+#include "new_wrapper.hpp"
+#include "sfmt.hpp"
+#include "counter_engines.hpp"
+#include "small_engines.hpp"
+#include "prng_pool.hpp"
+#include "async_prng.hpp"
+#include "joint.hpp"
+#include "yaml.hpp"
 
+#include <cstdio>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include <span>
+#include <cstring>
+#include <thread>
+#include <algorithm>
+
+
+static int Failures = 0; //!< Number of failed checks
+
+/** @brief Reports a failed check. */
+static void check(bool ok, const char* what)
+{
+	if(!ok)
+	{
+		std::printf("FAILED: %s\n", what);
+		Failures++;
+	}
+}
+
+
+/** @brief Bulk span APIs give the streams of the scalar calls. */
+static void test_bulk()
+{
+	PRNGWrapper<std::mt19937> a, b;
+	a.new_single_seed(1234u);
+	b.new_single_seed(1234u);
+
+	std::vector<double> uni(1000), gauss(1000);
+	std::vector<float> funi(100);
+	std::vector<std::mt19937::result_type> raw(700);
+	a.uni_fill(std::span<double>(uni));
+	a.gauss_fill(std::span<double>(gauss));
+	a.uni_fill(std::span<float>(funi));
+	a.engine_fill(std::span<std::mt19937::result_type>(raw));
+
+	bool same = true;
+	for(double x : uni)
+		{ same = same && x == b.uni(); }
+	for(double x : gauss)
+		{ same = same && x == b.gauss(); }
+	for(float x : funi)
+		{ same = same && x == static_cast<float>(b.uni()); }
+	for(auto x : raw)
+		{ same = same && x == b.Engine(); }
+	check(same, "uni_fill/gauss_fill/engine_fill match the scalar streams");
+	check(a.Engine == b.Engine, "bulk calls leave the Engine where the scalar calls do");
+}
+
+
+/** @brief SFMT19937 reproduces the reference output of init_gen_rand(1234) (SFMT.19937.out.txt),
+ * through `operator()` and through the bulk `generate()`. */
+static void test_sfmt()
+{
+	static constexpr std::uint32_t Reference[] = {3440181298u, 1564997079u, 1510669302u, 2930277156u, 1452439940u,
+	                                               3796268453u, 423124208u, 2143818589u, 3827219408u, 2987036003u};
+	sfmt19937 engine(1234);
+	bool same = true;
+	for(std::uint32_t x : Reference)
+		{ same = same && engine() == x; }
+	check(same, "sfmt19937 init_gen_rand(1234) reference output");
+
+	sfmt19937 a(1234), b(1234);
+	std::vector<sfmt19937::result_type> block(2000);
+	a.generate(std::span<sfmt19937::result_type>(block));
+	same = true;
+	for(auto x : block)
+		{ same = same && x == b(); }
+	check(same && a() == b(), "sfmt19937 generate() matches operator()");
+}
+
+
+/** @brief Checks `generate()`, `discard()` and `jump()` of a counter-based engine against `operator()`. */
+template <class Engine>
+static bool counter_engine_consistent(const typename Engine::key_type& key)
+{
+	Engine a(key), b(key);
+	std::vector<typename Engine::result_type> block(1001);
+	a.generate(std::span<typename Engine::result_type>(block));
+	bool same = true;
+	for(auto x : block)
+		{ same = same && x == b(); }
+
+	Engine c(key), d(key), e(key);
+	c.discard(4003);
+	d.jump(1, 12);
+	for(size_t i = 0; i < 4003; i++)
+		{ e(); }
+	same = same && c == e;
+	for(size_t i = 4003; i < 4096; i++)
+		{ c(); }
+	return same && c == d && a() == Engine(key, {250, 0, 0, 0}).block({250, 0, 0, 0})[1];
+}
+
+/** @brief Philox4x32-10 and Threefry4x32-20 reproduce the known-answer vectors of Random123 (kat_vectors). */
+static void test_counter_engines()
+{
+	using block_t = philox4x32::counter_type;
+	const block_t pi_ctr = {0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u};
+	const block_t ones = {~0u, ~0u, ~0u, ~0u};
+
+	check(philox4x32({0u, 0u}).block({}) == block_t{0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u} &&
+	      philox4x32({~0u, ~0u}).block(ones) == block_t{0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu} &&
+	      philox4x32({0xa4093822u, 0x299f31d0u}).block(pi_ctr) == block_t{0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u},
+	      "philox4x32-10 known-answer vectors");
+	check(threefry4x32({0u, 0u, 0u, 0u}).block({}) == block_t{0x9c6ca96au, 0xe17eae66u, 0xfc10ecd4u, 0x5256a7d8u} &&
+	      threefry4x32({~0u, ~0u, ~0u, ~0u}).block(ones) == block_t{0x2a881696u, 0x57012287u, 0xf6c7446eu, 0xa16a6732u} &&
+	      threefry4x32({0xa4093822u, 0x299f31d0u, 0x082efa98u, 0xec4e6c89u}).block(pi_ctr) == block_t{0x59cd1dbbu, 0xb8879579u, 0x86b5d00cu, 0xac8b6d84u},
+	      "threefry4x32-20 known-answer vectors");
+
+	check(counter_engine_consistent<philox4x32>({1u, 2u}), "philox4x32 generate()/discard()/jump() match operator()");
+	check(counter_engine_consistent<threefry4x32>({1u, 2u, 3u, 4u}), "threefry4x32 generate()/discard()/jump() match operator()");
+}
+
+
+/** @brief `mt_jump()` is stream-equal to `discard()` from several read positions (fresh, mid-block,
+ * block boundary). The states are compared by their output, not `operator==`. */
+template <class Engine>
+static bool mt_jump_matches_discard()
+{
+	bool same = true;
+	for(size_t position : {size_t(0), size_t(7), size_t(Engine::state_size)})
+	{
+		Engine a(5489u), b(5489u);
+		for(size_t i = 0; i < position; i++)
+			{ a(); b(); }
+		same = same && mt_jump(a, (1ULL << 22) + 12345);
+		b.discard((1ULL << 22) + 12345);
+		for(size_t i = 0; i < 2 * Engine::state_size; i++)
+			{ same = same && a() == b(); }
+	}
+	return same;
+}
+
+/** @brief Mersenne Twister jump-ahead against `discard()`, directly and through `PRNGWrapper::jump()`. */
+static void test_mt_jump()
+{
+	check(mt_jump_matches_discard<std::mt19937>(), "mt_jump() matches discard() for mt19937");
+	check(mt_jump_matches_discard<std::mt19937_64>(), "mt_jump() matches discard() for mt19937_64");
+
+	PRNGWrapper<std::mt19937_64> a;
+	a.new_single_seed(99u);
+	std::mt19937_64 b = a.Engine;
+	check(a.jump(3, 21) == PRNGWrapper<std::mt19937_64>::Success, "PRNGWrapper::jump()");
+	b.discard(3ULL << 21);
+	bool same = true;
+	for(size_t i = 0; i < 1000; i++)
+		{ same = same && a.Engine() == b(); }
+	check(same, "PRNGWrapper::jump(3, 21) matches discard(3 * 2^21)");
+}
+
+
+/** @brief Pool streams are those of `new_master_seed(master, i)`, and `local()` hands every thread its own stream. */
+static void test_pool()
+{
+	using Pool = PRNGPool<philox4x32>;
+	Pool pool(7, 4);
+	Pool::wrapper_type reference;
+	reference.set_compact_seeds(true);
+	reference.new_master_seed(7, 2);
+	bool same = true;
+	for(size_t i = 0; i < 1000; i++)
+		{ same = same && pool.get(2).uni() == reference.uni(); }
+	check(same, "PRNGPool::get(i) gives the stream of new_master_seed(master, i)");
+
+	Pool::wrapper_type* locals[4] = {};
+	bool stable[4] = {};
+	std::vector<std::thread> threads;
+	for(size_t t = 0; t < 4; t++)
+		{ threads.emplace_back([&, t]() { locals[t] = pool.local(); stable[t] = pool.local() == locals[t]; }); }
+	for(auto& thread : threads)
+		{ thread.join(); }
+	bool distinct = true;
+	for(size_t i = 0; i < 4; i++)
+	{
+		distinct = distinct && stable[i] && locals[i] != nullptr;
+		for(size_t j = 0; j < i; j++)
+			{ distinct = distinct && locals[i] != locals[j]; }
+	}
+	check(distinct && pool.local() == nullptr, "PRNGPool::local() hands out every stream once, stable per thread");
+
+	//The entry of a destroyed pool must not match a new pool, even at the same address
+	auto first = std::make_unique<Pool>(7, 2);
+	std::thread([&]() { first->local(); }).join();
+	first->local(); //Stream 1
+	first.reset();
+	auto second = std::make_unique<Pool>(7, 2);
+	check(second->local() == &second->get(0), "PRNGPool::local() on a new pool starts at stream 0");
+}
+
+
+/** @brief Binary checkpoints restore every wrapper of a file, and reject incomplete records
+ * and files of another wrapper type. */
+static void test_checkpoint()
+{
+	using Wrapper = PRNGWrapper<std::mt19937_64, 0, ziggurat_normal_distribution<double>>;
+	Wrapper a, b, c;
+	a.new_single_seed(1u);
+	b.new_single_seed(2u);
+	b.set_gauss_limits(-3.0, 0.5);
+	c.set_compact_seeds(true);
+	c.new_master_seed(3u, 1);
+	for(size_t i = 0; i < 1000; i++)
+		{ a.uni(); b.gauss(); c.uni(); }
+
+	Wrapper* saved[] = {&a, &b, &c};
+	check(Wrapper::save_checkpoint("prngw_test.ckpt", saved) == Wrapper::Success, "save_checkpoint()");
+
+	Wrapper ra, rb, rc;
+	Wrapper* loaded[] = {&ra, &rb, &rc};
+	check(Wrapper::load_checkpoint("prngw_test.ckpt", loaded) == Wrapper::Success, "load_checkpoint()");
+	check(ra.Engine == a.Engine && rb.Engine == b.Engine && rc.Engine == c.Engine, "load_checkpoint() restores the Engines");
+
+	Wrapper rb2;
+	check(rb2.load_state_binary("prngw_test.ckpt", 1) == Wrapper::Success && rb2.Engine == rb.Engine, "load_state_binary() of one record");
+	check(rb2.load_state_binary("prngw_test.ckpt", 3) == Wrapper::FileError, "load_state_binary() past the last record");
+
+	bool same = true;
+	for(size_t i = 0; i < 100; i++)
+		{ same = same && ra.uni() == a.uni() && rb.gauss() == b.gauss() && rc.uni() == c.uni(); }
+	check(same, "load_checkpoint() resumes the streams and the distributions");
+	check(rc.reload_seeds() == Wrapper::Success && rc.get_first_seed() == c.get_first_seed(), "load_checkpoint() restores the master seed");
+
+	std::vector<std::byte> record;
+	a.snapshot(record);
+	const std::mt19937_64 before = rb2.Engine;
+	check(rb2.restore(std::span<const std::byte>(record).first(record.size() / 2)) != Wrapper::Success && rb2.Engine == before,
+	      "restore() rejects an incomplete record and keeps the state");
+
+	PRNGWrapper<std::mt19937> other;
+	check(other.load_state_binary("prngw_test.ckpt") == PRNGWrapper<std::mt19937>::FileError, "load_state_binary() rejects another layout");
+	std::remove("prngw_test.ckpt");
+}
+
+
+/** @brief `save_state_async()` writes the state at the time of the call while the wrapper keeps drawing. */
+static void test_checkpoint_async()
+{
+	using Wrapper = PRNGWrapper<std::mt19937_64>;
+	Wrapper a;
+	a.new_single_seed(5u);
+	const std::mt19937_64 at_save = a.Engine;
+
+	bool called = false;
+	std::future<bool> done;
+	{
+		CheckpointWriter writer;
+		done = a.save_state_async(writer, "prngw_test_async.ckpt", [&called](bool ok) { called = ok; });
+		for(size_t i = 0; i < 100000; i++)
+			{ a.uni(); }
+		std::future<bool> second = a.save_state_async(writer, "prngw_test_async2.ckpt");
+		writer.wait();
+		check(writer.pending() == 0 && second.get(), "CheckpointWriter::wait() drains the queue");
+	} //The writer has joined, `called` is visible
+	check(done.get() && called, "save_state_async() reports success through the future and the callback");
+
+	Wrapper b, c;
+	check(b.load_state_binary("prngw_test_async.ckpt") == Wrapper::Success && b.Engine == at_save, "save_state_async() writes the state at the time of the call");
+	check(c.load_state_binary("prngw_test_async2.ckpt") == Wrapper::Success && c.Engine == a.Engine, "save_state_async() of a later state");
+	std::remove("prngw_test_async.ckpt");
+	std::remove("prngw_test_async2.ckpt");
+
+	CheckpointWriter writer;
+	check(!a.save_state_async(writer, "prngw_no_such_dir/state.ckpt").get(), "save_state_async() reports a failed write");
+}
+
+
+/** @brief Histogram edges, infinities, NaNs and values beyond the `size_t` range. */
+static void test_histogram()
+{
+	Histogram<4> h(0.0, 1.0);
+	const double inf = std::numeric_limits<double>::infinity();
+	for(double x : {0.0, 0.25, 0.999999, 1.0, 1e300, inf, -inf, -0.5, std::nan("")})
+		{ h.add(x); }
+	check(h.count(0) == 1 && h.count(1) == 1 && h.count(3) == 1, "Histogram bins");
+	check(h.overflow() == 3 && h.underflow() == 3, "Histogram rejects x >= Upper, infinities and NaN before the bin conversion");
+}
+
+
+/** @brief `sample_parallel()` and `joint_sample()` give the counts of the same shares drawn serially. */
+static void test_parallel_histograms()
+{
+	constexpr size_t Threads = 3;
+	constexpr std::uint64_t Samples = 100001;
+	PRNGPool<philox4x32> pool(11, Threads), serial_pool(11, Threads);
+
+	Histogram<16> parallel(0.0, 1.0), serial(0.0, 1.0);
+	sample_parallel(parallel, [&pool](size_t t, std::span<double> block) { pool.get(t).uni_fill(block); }, Samples, Threads);
+	for(size_t t = 0; t < Threads; t++)
+		for(std::uint64_t i = Samples * t / Threads; i < Samples * (t + 1) / Threads; i++)
+			{ serial.add(serial_pool.get(t).uni()); }
+	check(parallel.counts() == serial.counts() && parallel.total() == Samples, "sample_parallel() matches the serial shares");
+
+	JointHistogram<2> joint({0.0, 0.0}, {1.0, 1.0}, {4, 4});
+	joint_sample(joint, [&pool](size_t t, JointBlock<2>& block) {
+		for(size_t i = 0; i < block.size(); i++)
+		{
+			block.Coords[0][i] = pool.get(t).uni();
+			block.Coords[1][i] = pool.get(t).uni();
+		}
+	}, Samples, Threads);
+	JointHistogram<2> joint_serial({0.0, 0.0}, {1.0, 1.0}, {4, 4});
+	for(size_t t = 0; t < Threads; t++)
+	{
+		const std::uint64_t n = Samples * (t + 1) / Threads - Samples * t / Threads;
+		std::vector<double> x(n), y(n);
+		for(std::uint64_t i = 0; i < n; i++)
+		{
+			x[i] = serial_pool.get(t).uni();
+			y[i] = serial_pool.get(t).uni();
+		}
+		joint_serial.add({std::span<double>(x), std::span<double>(y)});
+	}
+	check(joint.counts() == joint_serial.counts() && joint.total() == Samples, "joint_sample() matches the serial shares");
+}
+
+
+/** @brief `YamlFile` drops output added before `open()` and reports failed writes. */
+static void test_yaml()
+{
+	{
+		YamlFile yaml("prngw_test.yaml");
+		yaml.buffered();
+		yaml.add_val("dropped", 1);
+		yaml.open();
+		yaml.add_val("kept", 2);
+		check(yaml.close(), "YamlFile::close()");
+	}
+	YamlFile in("prngw_test.yaml", std::ios::in);
+	check(in.parse() && in.read_val<int>("kept") == 2 && !in.has_key("dropped"), "YamlFile drops output added before open()");
+	std::remove("prngw_test.yaml");
+
+	YamlFile full("/dev/full");
+	if(full.open())
+	{
+		full.buffered(0);
+		for(size_t i = 0; i < 10000; i++)
+			{ full.add_val("key", i); }
+		check(!full.close(), "YamlFile::close() reports a failed write");
+	}
+
+	//Direct writes keep the format of operator<<, the emitter mode uses std::to_chars
+	for(size_t limit : {size_t(0), size_t(1) << 10})
+	{
+		{
+			YamlFile yaml("prngw_test.yaml");
+			yaml.open();
+			yaml.buffered(limit);
+			yaml.add_val("c", 'x');
+			yaml.add_val("i8", std::int8_t('y'));
+			yaml.add_val("b", true);
+			yaml.add_val("d", 0.1 + 0.2);
+			yaml.add_val("s", std::string("text"));
+			yaml.close();
+		}
+		YamlFile text("prngw_test.yaml", std::ios::in);
+		const bool direct = (limit == 0);
+		check(text.parse() && text.read_val<std::string>("c") == "x" && text.read_val<std::string>("i8") == "y" &&
+		      text.read_val<std::string>("b") == (direct ? "1" : "true") &&
+		      text.read_val<std::string>("d") == (direct ? "0.3" : "0.30000000000000004") && text.read_val<std::string>("s") == "text",
+		      direct ? "YamlFile direct writes format like operator<<" : "YamlFile emitter mode formats with to_chars");
+		std::remove("prngw_test.yaml");
+	}
+}
+
+/** @brief `YamlFile::parse()` reads back what `YamlFile` writes, and hand-written CRLF files. */
+static void test_yaml_reader()
+{
+	{
+		YamlFile yaml("prngw_test.yaml");
+		yaml.open();
+		yaml.push_level("run");
+		yaml.add_val("x", 1);
+		yaml.push_level("inner");
+		yaml.add_val("deep", 2.5);
+		yaml.pop_level();
+		yaml.push_level("item", true);
+		yaml.add_val("y", 2);
+		yaml.pop_level();
+		yaml.add_val("z", 3);
+		yaml.pop_level();
+		yaml.push_level("item", true);
+		yaml.add_val("y", 4);
+		yaml.pop_level();
+		yaml.add_val("flag", true);
+		yaml.add_val("switch", YamlFile::boolean(false, "on-off"));
+		yaml.add_val("name", YamlFile::quoted_str("a: b"));
+		yaml.add_array("block", std::vector<int>{1, 2, 3});
+		yaml.add_array("quoted", std::vector<std::string>{"\"k: v\"", "plain"});
+		yaml.add_flow_array("flow", std::vector<double>{0.5, -1.5});
+		yaml.doc_end();
+		yaml.close();
+	}
+	YamlFile in("prngw_test.yaml", std::ios::in);
+	check(in.parse(), "YamlFile::parse()");
+	check(in.read_val<int>("run.x") == 1 && in.read_val<double>("run.inner.deep") == 2.5 && in.read_val<int>("run.z") == 3,
+	      "YamlFile nested keys");
+	check(in.read_val<int>("run.item.y") == 2 && in.read_val<int>("item.y") == 4 && !in.has_key("run.y") && !in.has_key("run.inner.y"),
+	      "YamlFile dashed keys of push_level(key, true)");
+	check(in.read_val<bool>("flag", false) && !in.read_val<bool>("switch", true), "YamlFile bools");
+	check(in.read_val<std::string>("name") == "a: b" && in.read_val<std::string_view>("name") == "a: b", "YamlFile quoted strings");
+	check(in.read_array<int>("block") == std::vector<int>{1, 2, 3} && in.read_array<std::string>("quoted") == std::vector<std::string>{"k: v", "plain"} &&
+	      in.read_array<double>("flow") == std::vector<double>{0.5, -1.5}, "YamlFile block and flow arrays");
+	check(in.read_val<int>("missing", -1) == -1 && in.read_val<int>("run.missing", -1) == -1 && in.read_val<int>("run", -1) == -1 &&
+	      in.read_array<int>("missing").empty() && !in.has_key("x"), "YamlFile missing keys");
+	std::remove("prngw_test.yaml");
+
+	{
+		std::ofstream out("prngw_test.yaml", std::ios::binary);
+		out << "---\r\n# comment\r\nsection :\r\n  count : 7\r\n  values :\r\n    - 1.5\r\n    - 2.5\r\n  on : Yes\r\n...\r\nafter : 1\r\n";
+	}
+	YamlFile crlf("prngw_test.yaml", std::ios::in);
+	check(crlf.parse() && crlf.read_val<int>("section.count") == 7 && crlf.read_array<double>("section.values") == std::vector<double>{1.5, 2.5} &&
+	      crlf.read_val<bool>("section.on") && !crlf.has_key("after"), "YamlFile CRLF files");
+	std::remove("prngw_test.yaml");
+}
+
+
+/** @brief The distribution set is saved and restored by the json state files and the binary checkpoints. */
+static void test_dist_set()
+{
+	using Wrapper = PRNGWrapper<std::mt19937_64, 0, std::normal_distribution<double>, std::exponential_distribution<double>, std::poisson_distribution<int>>;
+	Wrapper a;
+	a.new_single_seed(8u);
+	a.dist<0>() = std::exponential_distribution<double>(3.0);
+	a.dist<1>() = std::poisson_distribution<int>(7.5);
+	for(size_t i = 0; i < 100; i++)
+		{ a.draw<0>(); a.draw<1>(); }
+
+	check(a.save_state("prngw_test_dists.json") == Wrapper::Success, "save_state() with a distribution set");
+	std::vector<std::byte> record;
+	a.snapshot(record);
+
+	Wrapper b, c;
+	check(b.load_state("prngw_test_dists.json") == Wrapper::Success && c.restore(record) == Wrapper::Success, "load_state()/restore() of a distribution set");
+	check(b.dist<0>().lambda() == 3.0 && b.dist<1>().mean() == 7.5 && c.dist<0>() == a.dist<0>() && c.dist<1>() == a.dist<1>(),
+	      "the distribution set parameters are restored");
+	bool same = true;
+	for(size_t i = 0; i < 100; i++)
+	{
+		const double x = a.draw<0>();
+		const int k = a.draw<1>();
+		same = same && b.draw<0>() == x && b.draw<1>() == k && c.draw<0>() == x && c.draw<1>() == k;
+	}
+	check(same, "restored distribution sets resume the streams");
+
+	Wrapper d;
+	d.new_single_seed(9u);
+	check(d.save_state("prngw_test_dists.json") == Wrapper::Success, "save_state() of the default distribution set");
+	nlohmann::json state = nlohmann::json::parse(std::ifstream("prngw_test_dists.json"));
+	state["dist_set_state"][1] = "not a distribution";
+	std::ofstream("prngw_test_dists.json") << state;
+	check(b.load_state("prngw_test_dists.json") == Wrapper::DistStateNotFound && b.dist<0>().lambda() == 3.0 && b.dist<1>().mean() == 7.5,
+	      "an invalid distribution set state leaves the whole set unchanged");
+	std::remove("prngw_test_dists.json");
+}
+
+
+/** @brief Alias tables round-trip through the checkpoints and corrupt tables are rejected. */
+static void test_alias()
+{
+	std::vector<double> weights(10000);
+	for(size_t i = 0; i < weights.size(); i++)
+		{ weights[i] = 1.0 + double(i % 7); }
+
+	using Wrapper = PRNGWrapper<std::mt19937_64, 0, std::normal_distribution<double>, alias_discrete_distribution<int>>;
+	Wrapper a, b;
+	a.new_single_seed(4u);
+	a.dist<0>() = alias_discrete_distribution<int>(std::span<const double>(weights));
+	std::vector<std::byte> record;
+	a.snapshot(record);
+	check(b.restore(record) == Wrapper::Success && b.dist<0>() == a.dist<0>(), "alias table checkpoint round-trip");
+	std::vector<int> x(1000), y(1000);
+	a.draw_fill<0>(std::span<int>(x));
+	for(auto& k : y)
+		{ k = b.draw<0>(); }
+	check(x == y, "restored alias table resumes the stream");
+
+	//serialize(): n, the weights, then the cells (64-bit threshold, 32-bit alias, padding)
+	std::vector<std::byte> bytes;
+	a.dist<0>().serialize(bytes);
+	const size_t cell_alias = sizeof(std::uint64_t) + weights.size() * sizeof(double) + sizeof(std::uint64_t);
+	const std::uint32_t bad = alias_discrete_distribution<int>::BlockSize;
+	std::memcpy(bytes.data() + cell_alias, &bad, sizeof(bad));
+	alias_discrete_distribution<int> c{1.0, 2.0};
+	size_t offset = 0;
+	check(!c.deserialize(bytes, offset) && offset == 0 && c.size() == 2, "alias deserialize() rejects an alias outside its block");
+
+	bytes.resize(bytes.size() / 2);
+	check(!c.deserialize(bytes, offset) && c.size() == 2, "alias deserialize() rejects a short record");
+}
+
+
+/** @brief `uni_fast_float()` and `uni_fast_fill<float>()` give one stream in any mix of calls. */
+template <class Engine>
+static bool fast_float_streams_match()
+{
+	PRNGWrapper<Engine> a, b;
+	a.new_single_seed(21u);
+	b.new_single_seed(21u);
+
+	std::vector<float> bulk(1001);
+	a.uni_fast_fill(std::span<float>(bulk));
+	bool same = true;
+	for(float x : bulk)
+		{ same = same && x == b.uni_fast_float(); }
+
+	//Odd spans and scalar calls interleaved, starting with and without a pending float
+	std::vector<float> part(7);
+	for(size_t round = 0; round < 10; round++)
+	{
+		a.uni_fast_fill(std::span<float>(part));
+		for(float x : part)
+			{ same = same && x == b.uni_fast_float(); }
+		const float x = b.uni_fast_float();
+		same = same && a.uni_fast_float() == x;
+	}
+	return same && a.Engine == b.Engine;
+}
+
+/** @brief Fast uniforms: one float stream in any mix of calls, the pending float is saved with
+ * the state, and `uni_fast_fill<double>()` gives the stream of `uni_fast()`. */
+static void test_fast_uniform()
+{
+	check(fast_float_streams_match<std::mt19937>(), "uni_fast_float() matches uni_fast_fill<float>() (32-bit engine)");
+	check(fast_float_streams_match<std::mt19937_64>(), "uni_fast_float() matches uni_fast_fill<float>() (64-bit engine)");
+
+	using Wrapper = PRNGWrapper<std::mt19937_64>;
+	Wrapper a, b, c;
+	a.new_single_seed(22u);
+	a.uni_fast_float(); //Leaves a pending float
+	std::vector<std::byte> record;
+	a.snapshot(record);
+	check(a.save_state("prngw_test_fast.json") == Wrapper::Success && b.load_state("prngw_test_fast.json") == Wrapper::Success &&
+	      c.restore(record) == Wrapper::Success, "state with a pending float");
+	const float x = a.uni_fast_float(), y = a.uni_fast_float();
+	check(b.uni_fast_float() == x && b.uni_fast_float() == y && c.uni_fast_float() == x && c.uni_fast_float() == y,
+	      "save_state()/snapshot() keep the pending float");
+	std::remove("prngw_test_fast.json");
+
+	Wrapper d, e;
+	d.new_single_seed(23u);
+	e.new_single_seed(23u);
+	std::vector<double> doubles(999);
+	d.uni_fast_fill(std::span<double>(doubles));
+	bool same = true;
+	for(double v : doubles)
+		{ same = same && v == e.uni_fast(); }
+	check(same && d.Engine == e.Engine, "uni_fast_fill<double>() matches uni_fast()");
+}
+
+/** @brief `uniform_int_fill()` gives the stream and the final Engine state of `uniform_int()`. */
+template <class Engine, class IntType>
+static bool int_streams_match(IntType lo, IntType hi)
+{
+	PRNGWrapper<Engine> a, b;
+	a.new_single_seed(31u);
+	b.new_single_seed(31u);
+
+	std::vector<IntType> bulk(1003);
+	a.uniform_int_fill(std::span<IntType>(bulk), lo, hi);
+	bool same = true;
+	for(IntType x : bulk)
+		{ same = same && x == b.uniform_int(lo, hi) && lo <= x && x <= hi; }
+	return same && a.Engine == b.Engine;
+}
+
+/** @brief Reference Lemire draw on 64-bit words, with the rejection threshold always computed. */
+static std::uint64_t lemire_reference(std::mt19937_64& engine, std::uint64_t range)
+{
+	const std::uint64_t threshold = (0 - range) % range;
+	for(;;)
+	{
+		const unsigned __int128 m = (unsigned __int128)engine() * range;
+		if(std::uint64_t(m) >= threshold)
+			{ return std::uint64_t(m >> 64); }
+	}
+}
+
+static void test_uniform_int()
+{
+	check(int_streams_match<std::mt19937>(1, 6), "uniform_int_fill() matches uniform_int() (32-bit engine, small range)");
+	check(int_streams_match<std::mt19937>(0u, 3000000000u), "uniform_int_fill() matches uniform_int() (32-bit engine, large range)");
+	check(int_streams_match<std::mt19937>(std::int64_t(-5), std::int64_t(1) << 40), "uniform_int_fill() matches uniform_int() (32-bit engine, 64-bit range)");
+	check(int_streams_match<std::mt19937>(std::numeric_limits<std::int32_t>::min(), std::numeric_limits<std::int32_t>::max()),
+	      "uniform_int_fill() matches uniform_int() (32-bit engine, full 32-bit range)");
+	check(int_streams_match<std::mt19937_64>(-1000, 1000), "uniform_int_fill() matches uniform_int() (64-bit engine, signed range)");
+	check(int_streams_match<std::mt19937_64>(std::uint64_t(0), (std::uint64_t(1) << 63) + 12345), "uniform_int_fill() matches uniform_int() (64-bit engine, large range)");
+	check(int_streams_match<std::mt19937_64>(std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max()),
+	      "uniform_int_fill() matches uniform_int() (64-bit engine, full range)");
+	check(int_streams_match<std::mt19937_64>(std::int8_t(-3), std::int8_t(-3)), "uniform_int_fill() matches uniform_int() (single value)");
+
+	//The values are those of Lemire's method on the raw words
+	std::mt19937_64 engine(41u), reference(41u);
+	bool same = true;
+	for(std::uint64_t range : {std::uint64_t(6), std::uint64_t(1000003), (std::uint64_t(1) << 63) + 1})
+	{
+		for(size_t i = 0; i < 1000; i++)
+			{ same = same && fast_uniform_int<std::uint64_t>(engine, 0, range - 1) == lemire_reference(reference, range); }
+	}
+	check(same && engine == reference, "fast_uniform_int() follows Lemire's method");
+
+	//No bias on a range that does not divide 2^32: the counts of 3 values stay within 5 sigma
+	PRNGWrapper<std::mt19937> wrapper;
+	wrapper.new_single_seed(43u);
+	std::vector<std::uint32_t> draws(300000);
+	wrapper.uniform_int_fill(std::span<std::uint32_t>(draws), 0u, 2u);
+	std::array<double, 3> counts{};
+	for(std::uint32_t x : draws)
+		{ counts[x]++; }
+	const double expected = double(draws.size()) / 3.0, sigma = std::sqrt(expected * 2.0 / 3.0);
+	bool flat = true;
+	for(double c : counts)
+		{ flat = flat && std::abs(c - expected) < 5.0 * sigma; }
+	check(flat, "uniform_int() counts are flat");
+
+	//One 32-bit word per value for a small range, two beyond 2^32
+	std::mt19937 words(43u);
+	words.discard(draws.size());
+	check(wrapper.Engine == words, "uniform_int() draws one word per value on a 32-bit engine");
+	std::vector<std::uint64_t> wide(1000);
+	wrapper.uniform_int_fill(std::span<std::uint64_t>(wide), std::uint64_t(0), std::uint64_t(1) << 40);
+	words.discard(2 * wide.size());
+	check(wrapper.Engine == words, "uniform_int() draws two words per value beyond 2^32 on a 32-bit engine");
+}
+
+/** @brief Advancing by `discard()` and by single steps leaves equal engines. */
+template <class Engine>
+static bool discard_matches_steps(Engine engine, unsigned long long z)
+{
+	Engine stepped = engine;
+	for(unsigned long long i = 0; i < z; i++)
+		{ stepped(); }
+	engine.discard(z);
+	return engine == stepped && engine() == stepped();
+}
+
+/** @brief Small engines: published reference outputs, and jumps against steps and against each other. */
+static void test_small_engines()
+{
+	//rand_xoshiro test vectors (state {1, 2, 3, 4}), from the reference C implementation
+	const std::uint64_t star_ref[10] = {11520ULL, 0ULL, 1509978240ULL, 1215971899390074240ULL, 1216172134540287360ULL,
+		607988272756665600ULL, 16172922978634559625ULL, 8476171486693032832ULL, 10595114339597558777ULL, 2904607092377533576ULL};
+	const std::uint64_t plus_ref[10] = {5ULL, 211106232532999ULL, 211106635186183ULL, 9223759065350669058ULL, 9250833439874351877ULL,
+		13862484359527728515ULL, 2346507365006083650ULL, 1168864526675804870ULL, 34095955243042024ULL, 3466914240207415127ULL};
+	xoshiro256starstar star(xoshiro256starstar::state_type{1, 2, 3, 4});
+	xoshiro256plus plus(xoshiro256plus::state_type{1, 2, 3, 4});
+	bool same = true;
+	for(size_t i = 0; i < 10; i++)
+		{ same = same && star() == star_ref[i] && plus() == plus_ref[i]; }
+	check(same, "xoshiro256**/xoshiro256+ reference outputs");
+
+	//pcg64 rng(42, 54) of the PCG reference library (pcg64 demo / check-pcg64.out)
+	const std::uint64_t pcg_ref[6] = {0x86B1DA1D72062B68ULL, 0x1304AA46C9853D39ULL, 0xA3670E9E0DD50358ULL,
+		0xF9090E529A7DAE00ULL, 0xC85B9FD837996F2CULL, 0x606121F8E3919196ULL};
+	pcg64 pcg(42u, 54u);
+	same = true;
+	for(std::uint64_t x : pcg_ref)
+		{ same = same && pcg() == x; }
+	check(same, "pcg64 reference outputs");
+
+	//Polynomial jumps against single steps, and against the published jump polynomials
+	check(discard_matches_steps(xoshiro256starstar(7u), 5000) && discard_matches_steps(xoshiro256plus(7u), 1ULL << 12),
+	      "xoshiro256 discard() matches single steps");
+	xoshiro256starstar j1(8u), j2(8u), j3(8u), j4(8u);
+	j1.jump();
+	j2.jump(1, 128);
+	j3.long_jump();
+	j4.jump(1, 192);
+	check(j1 == j2 && j3 == j4 && !(j1 == j3), "xoshiro256 jump()/long_jump() match jump(1, 128)/jump(1, 192)");
+	xoshiro256starstar k1(9u), k2(9u);
+	k1.jump(3, 20);
+	k2.discard(3ULL << 20);
+	check(k1 == k2, "xoshiro256 jump(3, 20) matches discard(3 * 2^20)");
+
+	check(discard_matches_steps(pcg64(11u), 5000) && discard_matches_steps(wyrand(11u), 5000), "pcg64/wyrand discard() matches single steps");
+	pcg64 p1(12u), p2(12u);
+	p1.jump(1, 127);
+	p1.jump(1, 127); //The full period
+	p2.jump(5, 20);
+	p2.jump(0xFFFFFFFFFFFFFFFFULL - 4, 20); //(5 + 2^64 - 5) 2^20 in total
+	pcg64 p3(12u);
+	p3.jump(1, 84);
+	check(p1 == pcg64(12u) && p2 == p3, "pcg64 jump() wraps around the period and adds distances");
+
+	wyrand w1(13u), w2(13u);
+	const bool jumped = w1.jump(3, 10);
+	w2.discard(3 << 10);
+	check(jumped && w1 == w2 && !w1.jump(1, 64) && w1 == w2, "wyrand jump() moves the counter and rejects 2^64");
+
+	//Pool streams are 2^64 apart - wyrand cannot reach them, the other small engines can
+	static_assert(has_stream_jump_v<xoshiro256starstar> && has_stream_jump_v<pcg64> && !has_stream_jump_v<wyrand>);
+	PRNGPool<xoshiro256starstar> pool(7u, 3);
+	PRNGWrapper<xoshiro256starstar> stream2;
+	stream2.new_master_seed(7u, 2);
+	const double x0 = pool.get(0).uni(), x1 = pool.get(1).uni(), x2 = pool.get(2).uni();
+	check(x0 != x1 && x1 != x2 && x0 != x2 && x2 == stream2.uni(), "PRNGPool streams of a small engine");
+}
+
+/** @brief Compact seed mode keeps only the master seed and stream id, and re-expands the same
+ * seeds, streams and files as the full Seed_list. */
+static void test_compact_seeds()
+{
+	using Wrapper = PRNGWrapper<std::mt19937, 100>;
+	Wrapper full, compact;
+	compact.set_compact_seeds(true);
+	check(full.new_master_seed(77u, 3) == Wrapper::Success && compact.new_master_seed(77u, 3) == Wrapper::Success,
+	      "compact new_master_seed()");
+	check(compact.compact() && compact.Seed_list.empty() && compact.get_seedlist() == full.get_seedlist() &&
+	      compact.get_first_seed() == full.get_first_seed() && compact.get_seedlist_size() == full.get_seedlist_size() &&
+	      compact.Engine == full.Engine, "compact mode re-expands the seeds of the master seed");
+
+	//reload_seeds() returns to the start of the substream
+	const std::uint32_t first = compact.Engine();
+	compact.Engine.discard(1000);
+	check(compact.reload_seeds() == Wrapper::Success && compact.Engine() == first, "compact reload_seeds() restarts the stream");
+
+	//Seed files and json states written in compact mode load into full wrappers and back
+	Wrapper from_seeds, from_state;
+	check(compact.save_seeds("prngw_test_compact.txt") == Wrapper::Success && from_seeds.old_seeds("prngw_test_compact.txt") == Wrapper::Success &&
+	      from_seeds.get_seedlist() == full.get_seedlist(), "compact save_seeds() writes the expanded seeds");
+	check(compact.save_state("prngw_test_compact.json") == Wrapper::Success && from_state.load_state("prngw_test_compact.json") == Wrapper::Success &&
+	      from_state.compact() && from_state.Engine == compact.Engine && from_state.get_seedlist() == full.get_seedlist(),
+	      "compact save_state()/load_state()");
+	std::remove("prngw_test_compact.txt");
+	std::remove("prngw_test_compact.json");
+
+	compact.set_compact_seeds(false);
+	check(!compact.compact() && compact.Seed_list == full.Seed_list, "leaving compact mode refills the Seed_list");
+
+	//new_seeds() in compact mode draws a 64-bit master seed and warms the engine up
+	Wrapper fresh, reference;
+	fresh.set_compact_seeds(true);
+	check(fresh.new_seeds() == Wrapper::Success && fresh.compact() && fresh.Seed_list.empty(), "compact new_seeds()");
+	reference.new_master_seed(fresh.get_master_seed());
+	reference.Engine.discard(100);
+	check(fresh.Engine == reference.Engine, "compact new_seeds() is new_master_seed() plus the warm-up");
+	const std::uint64_t master = fresh.get_master_seed();
+	check(fresh.new_seeds(false) == Wrapper::Success && fresh.get_master_seed() != master, "compact new_seeds() draws a new master seed");
+}
+
+/** @brief `parallel_fill()` gives the numbers of `uni_fill()` for any number of threads, and
+ * leaves an Engine that continues the stream of `uni_fill()`. */
+template <class Engine, typename RealType>
+static bool parallel_fill_matches(size_t n, size_t threads)
+{
+	PRNGWrapper<Engine> a, b;
+	a.new_single_seed(51u);
+	b.new_single_seed(51u);
+	a.uni();
+	b.uni();
+
+	std::vector<RealType> serial(n), parallel(n);
+	a.uni_fill(std::span<RealType>(serial));
+	b.parallel_fill(std::span<RealType>(parallel), threads);
+	bool same = serial == parallel;
+	for(size_t i = 0; i < 1000; i++)
+		{ same = same && a.Engine() == b.Engine(); }
+	return same;
+}
+
+static void test_parallel_fill()
+{
+	const size_t n = 4 * PRNGWrapper<philox4x32>::ParallelFillGrain + 5;
+	bool same = true;
+	for(size_t threads : {1, 2, 3, 4, 7})
+	{
+		same = same && parallel_fill_matches<philox4x32, double>(n, threads) && parallel_fill_matches<xoshiro256starstar, double>(n, threads) &&
+		       parallel_fill_matches<pcg64, float>(n, threads);
+	}
+	check(same, "parallel_fill() matches uni_fill() (counter-based and small engines)");
+
+	//2^21 doubles per thread: the second block starts 2^22 words in, past the discard() threshold of the MT jump
+	check(parallel_fill_matches<std::mt19937, double>(size_t(1) << 22, 2), "parallel_fill() matches uni_fill() (Mersenne Twister jump)");
+
+	//Fewer numbers than one block per thread run uni_fill() on the calling thread
+	check(parallel_fill_matches<std::mt19937_64, double>(1000, 8), "parallel_fill() of a small span");
+}
+
+/** @brief The rings of `AsyncPRNG` hold the streams of wrappers seeded with
+ * `new_master_seed(master, 2 * stream)` and `2 * stream + 1`, however the producer is timed. */
+template <class Engine>
+static bool async_streams_match(std::uint64_t stream)
+{
+	AsyncConfig config;
+	config.Capacity = 256; //Many refills and wrap-arounds of the rings
+	config.Batch = 48;
+	config.Poll = std::chrono::microseconds(1);
+	AsyncPRNG<Engine> async(61u, stream, config);
+
+	PRNGWrapper<Engine> uni_ref, gauss_ref;
+	uni_ref.new_master_seed(61u, 2 * stream);
+	gauss_ref.new_master_seed(61u, 2 * stream + 1);
+
+	bool same = true;
+	std::vector<double> block(100);
+	for(size_t round = 0; round < 200; round++)
+	{
+		double x;
+		while(!async.pop_uni(x))
+			{ std::this_thread::yield(); }
+		same = same && x == uni_ref.uni();
+		while(!async.pop_gauss(x))
+			{ std::this_thread::yield(); }
+		same = same && x == gauss_ref.gauss();
+
+		for(size_t done = 0; done < block.size(); )
+		{
+			const size_t n = (round % 2 == 0) ? async.pop_uni_n(std::span<double>(block).subspan(done))
+			                                  : async.pop_gauss_n(std::span<double>(block).subspan(done));
+			for(size_t i = done; i < done + n; i++)
+				{ same = same && block[i] == ((round % 2 == 0) ? uni_ref.uni() : gauss_ref.gauss()); }
+			done += n;
+			if(done < block.size())
+				{ std::this_thread::yield(); }
+		}
+	}
+	return same;
+}
+
+static void test_async()
+{
+	check(async_streams_match<philox4x32>(0) && async_streams_match<philox4x32>(5), "AsyncPRNG streams (philox4x32)");
+	check(async_streams_match<std::mt19937_64>(1), "AsyncPRNG streams (mt19937_64)");
+	check(async_streams_match<xoshiro256plus>(3) && async_streams_match<pcg64>(2), "AsyncPRNG streams (small engines)");
+
+	//A stopped producer leaves the rings as they are; pops beyond them count underruns
+	AsyncConfig config;
+	config.Capacity = 64;
+	AsyncPRNG<philox4x32> async(62u, 0, config);
+	async.stop();
+	std::vector<double> out(100);
+	const size_t n = async.pop_uni_n(std::span<double>(out));
+	double x;
+	const bool popped = async.pop_uni(x);
+	const AsyncUnderruns under = async.uni_underruns();
+	check(n == 64 && !popped && under.Events == 2 && under.Missing == 37 && async.gauss_underruns().Events == 0,
+	      "AsyncPRNG counts underruns");
+}
+
+/** @brief `PRNGInstrument` copies are snapshots; with `PRNGW_INSTRUMENT` the wrapper counts its draws. */
+static void test_instrument()
+{
+	PRNGInstrument<2> live;
+	live.count(prng_counter_t::UniDraws, 5);
+	live.count_dist(1, 3);
+	live.time(prng_timer_t::WarmUp, 1000);
+	PRNGInstrument<2> copy(live), assigned;
+	assigned = live;
+	live.count(prng_counter_t::UniDraws, 1);
+	const PRNGStats snap = copy.snapshot();
+	check(snap[prng_counter_t::UniDraws] == 5 && snap.DistDraws[1] == 3 && snap[prng_timer_t::WarmUp].Count == 1 &&
+	      snap[prng_timer_t::WarmUp].MaxNs == 1000 && assigned.snapshot()[prng_counter_t::UniDraws] == 5 &&
+	      live.snapshot()[prng_counter_t::UniDraws] == 6, "PRNGInstrument copies snapshot the counters");
+
+#ifdef PRNGW_INSTRUMENT
+	PRNGWrapper<std::mt19937_64> wrapper;
+	wrapper.new_master_seed(71u);
+	std::vector<double> out(100);
+	wrapper.uni_fill(std::span<double>(out));
+	wrapper.uni();
+	wrapper.gauss();
+	const PRNGStats stats = wrapper.stats();
+	check(stats[prng_counter_t::UniDraws] == 101 && stats[prng_counter_t::GaussDraws] == 1 && stats[prng_counter_t::FillCalls] == 1 &&
+	      stats[prng_counter_t::Seedings] == 1, "PRNGW_INSTRUMENT counts the draws of the wrapper");
+#endif
+}
+
+
+/** @brief RANDU, x <- 65539 x mod 2^31, shifted to a full 32-bit word. Its triples lie on 15 planes. */
+struct Randu
+{
+	using result_type = std::uint32_t;
+	std::uint32_t State = 1; //!< Odd seed
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return 0xFFFFFFFFu; }
+	result_type operator()()
+	{
+		State = (State * 65539u) & 0x7FFFFFFFu;
+		return State << 1;
+	}
+};
+
+/** @brief The statistical battery passes mt19937 at `Scale` 1, and RANDU fails birthday spacings and matrix rank. */
+static void test_stat_battery()
+{
+	using Wrapper = PRNGWrapper<std::mt19937>;
+	Wrapper mt;
+	mt.new_single_seed(1234u);
+	const StatReport good = Wrapper::Experimental::testU01(mt, {1});
+	check(good.Results.size() == 8 && good.all_passed(), "mt19937 passes the statistical battery");
+
+	const StatReport bad = stat_battery([](size_t chunk) { return Randu{std::uint32_t(12345 + 2 * chunk)}; }, {1});
+	auto failed = [&](const char* name) {
+		return std::any_of(bad.Results.begin(), bad.Results.end(), [&](const StatTestResult& r) {
+			return r.Name.starts_with(name) && !r.Passed;
+			});
+		};
+	check(failed("birthday spacings") && failed("matrix rank"), "RANDU fails birthday spacings and matrix rank");
+}
+
+
+/** @brief `JointHistogram::independence()` of consecutive triples passes mt19937 and catches the planes of RANDU. */
+static void test_independence()
+{
+	constexpr size_t Points = 1 << 20;
+	auto triples = [](auto engine) {
+		JointHistogram<3> joint({0.0, 0.0, 0.0}, {1.0, 1.0, 1.0}, {16, 16, 16});
+		std::array<std::vector<double>, 3> coords;
+		for(auto& c : coords)
+			{ c.resize(Points); }
+		for(size_t i = 0; i < Points; i++)
+			for(auto& c : coords)
+				{ c[i] = double(engine()) * 0x1p-32; }
+		joint.add({std::span<double>(coords[0]), std::span<double>(coords[1]), std::span<double>(coords[2])});
+		return joint.independence().PValue;
+		};
+	check(triples(std::mt19937(1234u)) > 0.001, "mt19937 triples pass the independence test");
+	check(triples(Randu{12345}) < 0.001, "RANDU triples fail the independence test");
+}
+
+
+/** @brief Ziggurat gaussians: the batched `gauss_fill()` gives the scalar stream, the mean, variance
+ * and tail mass match the normal distribution, and the json state round-trips the distribution. */
+static void test_ziggurat()
+{
+	using Wrapper = PRNGWrapper<std::mt19937_64, 0, ziggurat_normal_distribution<double>>;
+	Wrapper a, b;
+	a.new_single_seed(42u);
+	b.new_single_seed(42u);
+	a.set_gauss_limits(1.5, 2.0);
+	b.set_gauss_limits(1.5, 2.0);
+
+	std::vector<double> out(10000);
+	a.gauss_fill(std::span<double>(out));
+	bool same = true;
+	double sum = 0;
+	for(double x : out)
+	{
+		same = same && x == b.gauss();
+		sum += x;
+	}
+	check(same && a.Engine == b.Engine, "ziggurat gauss_fill() matches gauss() and the final Engine state");
+	check(std::abs(sum / double(out.size()) - 1.5) < 0.1, "ziggurat gauss() mean");
+
+	//Moments and tail mass of 10^6 draws, at 5 standard errors: P(|z| > 3) = erfc(3 / sqrt(2))
+	std::vector<double> many(1000000);
+	a.gauss_fill(std::span<double>(many));
+	double mean = 0, var = 0;
+	size_t tail = 0;
+	for(double x : many)
+		{ mean += x; }
+	mean /= double(many.size());
+	for(double x : many)
+	{
+		var += (x - mean) * (x - mean);
+		tail += std::abs(x - 1.5) > 3 * 2.0;
+	}
+	var /= double(many.size() - 1);
+	const double n = double(many.size()), tail_p = std::erfc(3 / std::sqrt(2.0));
+	check(std::abs(mean - 1.5) < 5 * 2.0 / std::sqrt(n), "ziggurat gauss() mean of 10^6 draws");
+	check(std::abs(var - 4.0) < 5 * 4.0 * std::sqrt(2 / n), "ziggurat gauss() variance");
+	check(std::abs(double(tail) / n - tail_p) < 5 * std::sqrt(tail_p * (1 - tail_p) / n), "ziggurat gauss() tail mass P(|z| > 3)");
+
+	check(a.save_state("prngw_test_state.json") == Wrapper::Success, "ziggurat save_state()");
+	const double next = a.gauss();
+	Wrapper c;
+	check(c.load_state("prngw_test_state.json") == Wrapper::Success && c.gauss() == next, "ziggurat load_state() resumes the stream");
+	std::remove("prngw_test_state.json");
+}
+
+
+/** @brief Buffered `Urandom` reads across buffer refills, and a failed read leaves the buffer consistent. */
+static void test_urandom()
+{
+	Urandom source;
+	bool ok = source.open();
+	std::uint32_t word = 0;
+	for(size_t i = 0; i < 3 * Urandom::BufferSize / sizeof(word); i++)
+		{ ok = ok && source.get(word); }
+	ok = ok && source.get(word) && source.available() == Urandom::BufferSize - sizeof(word);
+	std::vector<std::uint64_t> bulk(1000);
+	ok = ok && source.get_n(std::span<std::uint64_t>(bulk));
+	source.close();
+	check(ok, "Urandom get()/get_n() across buffer refills");
+	check(source.available() == 0, "Urandom close() drops the buffer");
+
+#if !URANDOM_GETRANDOM
+	Urandom closed; //Never opened - every refill fails
+	check(!closed.get(word) && !closed.get(word), "Urandom get() reports a failed refill");
+#else
+	//The /dev/urandom fallback of a getrandom(2) that fails as unavailable
+	Urandom::disable_getrandom();
+	Urandom fallback;
+	std::array<std::uint64_t, 4> key{};
+	check(fallback.open() && fallback.get_n(std::span<std::uint64_t>(bulk)) && fallback.get(word) &&
+	      Urandom::fill(std::span<std::uint64_t>(key)) && key != std::array<std::uint64_t, 4>{}, "Urandom falls back to /dev/urandom");
+#endif
+}
 
 
 int main()
 {
 	hist_gen();
-}
+	test_histogram();
+	test_parallel_histograms();
+	test_yaml();
+	test_yaml_reader();
 
+	test_bulk();
+	test_urandom();
+	test_sfmt();
+	test_counter_engines();
+	test_small_engines();
+	test_mt_jump();
+	test_pool();
+	test_compact_seeds();
+	test_checkpoint();
+	test_checkpoint_async();
+	test_async();
+	test_dist_set();
+	test_alias();
+	test_fast_uniform();
+	test_uniform_int();
+	test_parallel_fill();
+	test_stat_battery();
+	test_independence();
+	test_ziggurat();
+	test_instrument();
 
+	std::printf("%s\n", Failures == 0 ? "All checks passed." : "Checks failed.");
+	return Failures == 0 ? 0 : 1;
+}
@@ -1,44 +1,85 @@
 #pragma once
 #include<unistd.h>
 #include<fcntl.h>
+#include<cerrno>
+#include <cstring>
+#include <memory>
+#include <span>
 #include <type_traits>
+#include <atomic>
+
+/// Selects the entropy backend at compile time. `1` uses the `getrandom(2)` syscall (no file
+/// descriptor, safe to call from many threads at once) and falls back to the `/dev/urandom` file
+/// at runtime if the syscall is unavailable (ENOSYS on old kernels, EPERM under seccomp filters);
+/// `0` always reads the `/dev/urandom` file.
+/// Defaults to `getrandom(2)` on linux systems that provide `<sys/random.h>`.
+#ifndef URANDOM_GETRANDOM
+	#if defined(__linux__) && __has_include(<sys/random.h>)
+		#define URANDOM_GETRANDOM 1
+	#else
+		#define URANDOM_GETRANDOM 0
+	#endif
+#endif
+
+#if URANDOM_GETRANDOM
+	#include <sys/random.h>
+#endif
 
 
 /** @brief Describes a RAII wrapper around the `/dev/urandom` file for linux systems that 
- * reads random bits and constructs type that is passed as the template arguement. */
+ * reads random bits and constructs type that is passed as the template arguement.
+ * Reads go through an internal buffer of `BufferSize` bytes that is refilled with a single
+ * `read()`, hence repeated calls of `get()` do not cost one syscall each. The buffer is
+ * allocated on the first read and lives until `close()` (or the destructor), which zeroes and
+ * frees it, so unused entropy does not stay in memory and a closed object holds no heap.
+ * With the `getrandom(2)` backend (`URANDOM_GETRANDOM`) no file is involved: `open()` and
+ * `close()` only set the open flag and `get()`/`get_n()` also work on an unopened object. Once
+ * the syscall fails as unavailable, every object opens `/dev/urandom` on its first refill instead.
+ * A single object is not meant to be shared between threads; use the static `fill()`,
+ * which has no buffer, for concurrent reads. */
 class Urandom
 {
+public:
+	static constexpr size_t BufferSize = 4096; //!< Size of the internal buffer in bytes
 
+private:
 	int FileDesc; //!< File descriptor for open
 	bool OpenFlag; //!< Open Status of the urandom file
+	std::unique_ptr<unsigned char[]> Buffer; //!< Buffered random bytes
+	size_t BufferPos; //!< Position of the next unread byte in the buffer
+	size_t BufferFill; //!< Number of valid bytes in the buffer
 
 public:
 
 	/** @brief Constructor -> Sets the read size. */
-	Urandom(): FileDesc(-1), OpenFlag(false)
+	Urandom(): FileDesc(-1), OpenFlag(false), BufferPos(0), BufferFill(0)
 	{}
 
-	/** @brief Destructor -> Closes the file. */
+	/** @brief Destructor -> Closes the file and wipes the buffer. */
 	~Urandom()
 	{
-		if(OpenFlag)
-		{
-			close(FileDesc);
-		}
+		close();
 	}
 
+	Urandom(const Urandom&) = delete;
+	Urandom& operator=(const Urandom&) = delete;
+
 	/** @brief Opens the urandom file. */
 	bool inline open() __attribute__((always_inline))
 	{
-		FileDesc = open("/dev/urandom", O_RDONLY, O_NONBLOCK); //Non-blocking mode implemented
-
-		if (FileDesc != -1)
+		if(OpenFlag)
 		{
-			Open_flag = true;
 			return true;
 		}
 
-		return false;
+	#if URANDOM_GETRANDOM
+		OpenFlag = true;
+		return true;
+	#else
+		FileDesc = ::open("/dev/urandom", O_RDONLY | O_NONBLOCK | O_CLOEXEC); //Non-blocking mode implemented
+		OpenFlag = (FileDesc != -1);
+		return OpenFlag;
+	#endif
 	}
 
 	/** @brief Returns the open status of the urandom file object. */
@@ -47,30 +88,208 @@ public:
 		return OpenFlag;
 	}
 
-	/** @brief Close the file without destroying the object. */
+	/** @brief Close the file without destroying the object. The buffer is zeroed and freed. */
 	void inline close() __attribute__((always_inline))
 	{
-		Open_flag = false;
-		close(FileDesc);
+		if(FileDesc != -1)
+		{
+			::close(FileDesc);
+		}
+		OpenFlag = false;
+		FileDesc = -1;
+		wipe();
+	}
 
+	/** @brief Returns the number of buffered bytes not read yet. */
+	size_t inline available() const
+	{
+		return BufferFill - BufferPos;
 	}
 
 
-	/** @brief Reads `sizeof(Type)` number of random bits and return the constructed type. Template specialization */
+	/** @brief Reads `sizeof(Type)` random bytes into `value`.
+	 * Returns false, and leaves `value` and the buffer unchanged, if the source fails. */
+	template <typename Type>
+	bool inline get(Type& value)
+	{
+		static_assert(std::is_trivially_copyable_v<Type> && !std::is_floating_point_v<Type>,
+		              "Urandom::get() requires a trivially copyable, non floating point type.");
+		static_assert(sizeof(Type) <= BufferSize, "Urandom::get() type is larger than the buffer.");
+
+		if(BufferFill - BufferPos < sizeof(Type) && !refill())
+		{
+			return false;
+		}
+		std::memcpy(&value, Buffer.get() + BufferPos, sizeof(Type));
+		BufferPos += sizeof(Type);
+		return true;
+	}
+
+	/** @brief Reads `sizeof(Type)` number of random bits and return the constructed type.
+	 * Returns a zero value if the source fails; use `get(value)` to see the status. */
 	template <typename Type>
 	Type inline get()
 	{
-		
-		if constexpr (std::is_floating_point<Type>) 
-		{}
+		Type read_value{};
+		get(read_value);
+		return read_value;
+	}
+
+	/** @brief Fills the span with random values of `Type`. Buffered bytes are used first,
+	 * requests larger than the buffer are read directly into the span.
+	 * Returns false if the source could not deliver all the requested bytes. */
+	template <typename Type>
+	bool get_n(std::span<Type> out)
+	{
+		static_assert(std::is_trivially_copyable_v<Type>, "Urandom::get_n() requires a trivially copyable type.");
+
+		unsigned char* dest = reinterpret_cast<unsigned char*>(out.data());
+		size_t remaining = out.size_bytes();
+
+		//Drain the buffer
+		size_t available = BufferFill - BufferPos;
+		size_t take = (remaining < available) ? remaining : available;
+		if(take > 0)
+		{
+			std::memcpy(dest, Buffer.get() + BufferPos, take);
+			BufferPos += take;
+			dest += take;
+			remaining -= take;
+		}
+
+		if(remaining >= BufferSize)
+		{
+			return read_bytes(dest, remaining);
+		}
+
+		else if(remaining > 0)
+		{
+			if(!refill())
+				{ return false; }
+			std::memcpy(dest, Buffer.get(), remaining);
+			BufferPos = remaining;
+		}
+
+		return true;
+	}
+
+	/** @brief Fills the span with random values of `Type` without touching any object state.
+	 * Safe to call from many threads at once with the `getrandom(2)` backend; the file
+	 * backend and the fallback open and close `/dev/urandom` for every call. */
+	template <typename Type>
+	static bool fill(std::span<Type> out)
+	{
+		static_assert(std::is_trivially_copyable_v<Type>, "Urandom::fill() requires a trivially copyable type.");
+
+	#if URANDOM_GETRANDOM
+		int fd = -1; //Opened by the fallback only
+	#else
+		int fd = ::open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+	#endif
+		const bool status = read_any(fd, reinterpret_cast<unsigned char*>(out.data()), out.size_bytes());
+		if(fd != -1)
+			{ ::close(fd); }
+		return status;
+	}
+
+	/** @brief Makes every later read use the `/dev/urandom` file, as after `getrandom(2)` failed
+	 * with ENOSYS or EPERM. No effect on the file backend. */
+	static void disable_getrandom()
+	{
+		getrandom_unavailable().store(true, std::memory_order_relaxed);
+	}
+
+private:
+//Helper Functions
+
+	/** @brief Reads exactly `size` bytes, retrying on partial reads and interrupts. */
+	bool read_bytes(unsigned char* dest, size_t size)
+	{
+	#if URANDOM_GETRANDOM
+		return read_any(FileDesc, dest, size);
+	#else
+		return read_source(FileDesc, dest, size);
+	#endif
+	}
+
+	/** @brief Set once `getrandom(2)` failed as unavailable, shared by all the objects. */
+	static std::atomic<bool>& getrandom_unavailable()
+	{
+		static std::atomic<bool> unavailable{false};
+		return unavailable;
+	}
 
-		else
+	/** @brief Reads exactly `size` bytes with `getrandom(2)`, or from `/dev/urandom` (opened into
+	 * `fd` if it is -1) once the syscall is unavailable. The file backend reads `fd` only. */
+	static bool read_any(int& fd, unsigned char* dest, size_t size)
+	{
+	#if URANDOM_GETRANDOM
+		if(!getrandom_unavailable().load(std::memory_order_relaxed))
+		{
+			if(read_source(-1, dest, size))
+				{ return true; }
+			if(errno != ENOSYS && errno != EPERM)
+				{ return false; }
+			getrandom_unavailable().store(true, std::memory_order_relaxed);
+		}
+		if(fd == -1)
+			{ fd = ::open("/dev/urandom", O_RDONLY | O_CLOEXEC); }
+	#else
+		if(fd == -1)
+			{ return false; }
+	#endif
+		return fd != -1 && read_source(fd, dest, size);
+	}
+
+	/** @brief Reads exactly `size` bytes from `fd`, or with `getrandom(2)` if `fd` is -1. */
+	static bool read_source(int fd, unsigned char* dest, size_t size)
+	{
+		while(size > 0)
+		{
+		#if URANDOM_GETRANDOM
+			ssize_t rcode = (fd == -1) ? ::getrandom(dest, size, 0) : ::read(fd, dest, size);
+		#else
+			ssize_t rcode = ::read(fd, dest, size);
+		#endif
+			if(rcode > 0)
+			{
+				dest += rcode;
+				size -= static_cast<size_t>(rcode);
+			}
+			else if(rcode == -1 && errno == EINTR)
+				{ continue; }
+			else
+				{ return false; }
+		}
+		return true;
+	}
+
+	/** @brief Zeroes (through a volatile pointer, so the stores are kept) and frees the buffer. */
+	void wipe()
+	{
+		if(Buffer)
+		{
+			volatile unsigned char* bytes = Buffer.get();
+			for(size_t i = 0; i < BufferSize; i++)
+				{ bytes[i] = 0; }
+			Buffer.reset();
+		}
+		BufferPos = BufferFill = 0;
+	}
+
+	/** @brief Refills the whole buffer with a single read. Unread bytes are discarded.
+	 * The buffer is left empty (`BufferPos == BufferFill`) if the read fails. */
+	bool refill()
+	{
+		BufferPos = BufferFill = 0;
+		if(!Buffer)
 		{
-			Type read_value; //Explicitly use garbage value
-			ssize_t rcode = read(FileDesc, &read_value, sizeof(Type));
-			return read_value;
+			Buffer.reset(new unsigned char[BufferSize]);
 		}
-		
+		if(!read_bytes(Buffer.get(), BufferSize))
+			{ return false; }
+		BufferFill = BufferSize;
+		return true;
 	}
 
 };
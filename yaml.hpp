@@ -1,7 +1,23 @@
 #pragma once
 #include <iostream>
+#include <fstream>
 #include <algorithm>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <type_traits>
+#include <unordered_map>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 
 
@@ -12,25 +28,59 @@
 class YamlFile
 {
 	uint8_t level = 0;
+	std::vector<char> Buffer; //!< Output buffer of the emitter mode, reused across documents
+	size_t BufferLimit = 0; //!< Buffer size that triggers a flush, 0 writes every token directly
+	std::ostringstream Scratch; //!< Reused to format the values that only have an `operator<<`
+
+	/** @brief Indexed key of the parsed document. All the views point into the mapped file. */
+	struct Entry
+	{
+		std::string_view Key; //!< Last component of the key
+		std::string_view Value; //!< Scalar or flow value, empty for parents and block arrays
+		uint32_t FirstItem = 0; //!< First block array item in `Items`
+		uint32_t ItemCount = 0; //!< Number of block array items
+	};
+
+	/** @brief The keys are already hashes. */
+	struct IdentityHash
+	{
+		size_t operator()(uint64_t h) const { return size_t(h); }
+	};
+
+	const char* Map = nullptr; //!< Mapped input file
+	size_t MapSize = 0; //!< Size of the mapping
+	std::unordered_map<uint64_t, Entry, IdentityHash> Index; //!< Hash of the fully qualified key -> entry
+	std::vector<std::string_view> Items; //!< Block array items of all the keys
 public:
 	std::string filename;
-	uint8_t mode;
+	std::ios::openmode mode;
+	std::string indent;
 	std::fstream file;
-	std::vector<std::string> parsed;
 
 
 	//0
-	YamlFile(std::string filename, uint8_t mode = std::ios::out, std::string indent = "\t"): filename(filename), mode(mode)
+	YamlFile(std::string filename, std::ios::openmode mode = std::ios::out, std::string indent = "\t"): filename(filename), mode(mode), indent(indent)
 	{}
 
+	~YamlFile()
+	{
+		flush();
+		unmap();
+	}
+
+	YamlFile(const YamlFile&) = delete;
+	YamlFile& operator=(const YamlFile&) = delete;
+
 	//1
 	/** @brief Open file for operation. 
-	 * Automatically inits a new YAML document if the file mode is not input (`st::ios::in`). */
+	 * Automatically inits a new YAML document if the file mode is not input (`st::ios::in`).
+	 * Output added while no file was open is dropped, the document starts with `---`. */
 	bool open()
 	{
+		Buffer.clear();
 		file.open(filename, mode);
 		bool open_ =  file.is_open();
-		if(open_ && !(mode & (1 << sd::ios::in) != 0)) //not input mode
+		if(open_ && !(mode & std::ios::in)) //not input mode
 		{
 			doc_start();
 		}
@@ -38,39 +88,146 @@ public:
 	}
 
 	//2
-	/** @brief Close file for operation. */
+	/** @brief Close file for operation. Pending output of the emitter mode is written first.
+	 * \return false if the file is still open or any write to it failed. */
 	bool close()
 	{
+		if(!file.is_open())
+			{ Buffer.clear(); return true; }
+		const bool written = flush() && !file.fail();
 		file.close();
-		return !file.is_open();
+		return written && !file.fail() && !file.is_open();
+	}
+
+	//2.1
+	/** @brief Switches to the emitter mode - output is collected in a reusable buffer of
+	 * `bytes` bytes and written in large chunks, numbers are formatted with `std::to_chars`
+	 * (shortest round-trip doubles, `true`/`false` for bools, see `emit()`).
+	 * Passing 0 returns to writing every token directly, in the format of `operator<<`. */
+	void buffered(size_t bytes = size_t(1) << 20)
+	{
+		flush();
+		BufferLimit = bytes;
+		Buffer.reserve(bytes + 256);
+	}
+
+	//2.2
+	/** @brief Writes the pending output of the emitter mode to the file. Output added while no
+	 * file is open is dropped. A failed write leaves `file` in the failed state (`file.fail()`);
+	 * errors of the stream buffer may only surface at `close()`.
+	 * \return false if the write failed. */
+	bool flush()
+	{
+		bool written = true;
+		if(!Buffer.empty() && file.is_open())
+			{ written = static_cast<bool>(file.write(Buffer.data(), std::streamsize(Buffer.size()))); }
+		Buffer.clear();
+		return written;
 	}
 
 	//3
-	/** @brief Parse a file to an internal variable `parsed`.
-	 * Function only works if the file mode is input `in`.*/
-	void parse()
+	/** @brief Parses the first document of the file into an index of fully qualified keys
+	 * (`parent.child.key`). The file is memory-mapped and tokenized in place - the index holds
+	 * `std::string_view`s into the mapping, nothing is copied per line. Block arrays
+	 * (`- item` lines) and flow arrays (`[a, b]`) are both indexed under their key; a dashed
+	 * key (`- key :`, see `push_level()`) is a key, repeated ones keep the last occurrence.
+	 * Function only works if the file mode is input `in`.
+	 * \return false if the file could not be mapped.
+	 * \attention The views stay valid until the object is destroyed or the file is parsed again. */
+	bool parse()
 	{
-		if(mode & (1 << std::ios::in))
+		if(!(mode & std::ios::in))
+			return false;
+
+		unmap();
+		Index.clear();
+		Items.clear();
+		if(!map())
+			return false;
+
+		struct Parent
+		{
+			size_t Indent;
+			uint64_t Hash;
+		};
+		std::vector<Parent> parents; //Open keys, outermost first
+		Entry* last = nullptr; //Last key, receives the block array items that follow it
+		bool started = false;
+
+		const char* p = Map;
+		const char* end = Map + MapSize;
+		while(p < end)
 		{
-			std::string ymlstr;
-			uint8_t ymlend = uint8_t(false);
-			enum ymlendstate {false_ = 0, first = 1, second = 2};
-			unsigned int lineno = 0;
+			const char* eol = static_cast<const char*>(std::memchr(p, '\n', size_t(end - p)));
+			if(eol == nullptr)
+				eol = end;
+			std::string_view line(p, size_t(eol - p));
+			p = eol + 1;
 
-			while (std::getline(file, ymlstr) && ymlend != second)
+			if(!line.empty() && line.back() == '\r')
+				line.remove_suffix(1);
+
+			//Document markers
+			if(line == "---")
+			{
+				if(started)
+					break;
+				started = true;
+				continue;
+			}
+			if(line == "...")
+				break;
+
+			const size_t indent_width = line.find_first_not_of(" \t");
+			if(indent_width == std::string_view::npos || line[indent_width] == '#')
+				continue; //Blank line or comment
+			std::string_view body = trim(line.substr(indent_width));
+
+			//Block array item, or a `- key :` of `push_level(key, true)` that is parsed as a key
+			if(body[0] == '-' && (body.size() == 1 || body[1] == ' '))
 			{
-			    lineno++;
-			    // Line contains string of length > 0 then save it in vector
-			        if(ymlstr == "---" && ymlend == false_)
-			        	ymlend = first;
-			        else if(ymlstr == "---" && ymlend == first)
-			        	ymlend = second;
-			        else if(ymlstr.size() > 0)
-			        	parsed.push_back(ymlstr);
-			        else
-			        	std::cerr << "YAML::parse failed at line: " << lineno << ".\n";
+				const std::string_view item = trim(body.substr(1));
+				const bool quoted = !item.empty() && (item.front() == '"' || item.front() == '\'');
+				if(quoted || find_colon(item) == std::string_view::npos)
+				{
+					if(last != nullptr && last->Value.empty())
+					{
+						if(last->ItemCount == 0)
+							last->FirstItem = uint32_t(Items.size());
+						Items.push_back(item);
+						last->ItemCount++;
+					}
+					continue;
+				}
+				body = item;
 			}
+
+			//key : value
+			const size_t colon = find_colon(body);
+			if(colon == std::string_view::npos)
+				continue;
+			const std::string_view key = trim(body.substr(0, colon));
+			const std::string_view value = trim(body.substr(colon + 1));
+
+			while(!parents.empty() && parents.back().Indent >= indent_width)
+				parents.pop_back();
+
+			const uint64_t hash = key_hash(parents.empty() ? HashSeed : parents.back().Hash, !parents.empty(), key);
+			Entry& entry = Index[hash];
+			entry = Entry{key, value, 0, 0};
+			last = &entry;
+
+			if(value.empty())
+				parents.push_back({indent_width, hash});
 		}
+		return true;
+	}
+
+	//3.1
+	/** @brief Returns true if the parsed document has the fully qualified key. */
+	bool has_key(std::string_view key) const
+	{
+		return find(key) != nullptr;
 	}
 
 	//! Actual useful functions
@@ -80,85 +237,132 @@ public:
 	template <typename KeyType, typename ValueType>
 	void add_val(KeyType key, ValueType value)
 	{
-		//Write text
-		for(unsigned int i = 0; i < level; i++)
-			file << indent;
-		
-		file << key << " : " << value << '\n';
+		emit_indent();
+		emit(key);
+		emit(" : ");
+		emit(value);
+		emit('\n');
+		commit();
 	}
 
 	//5
 	/** @brief Add a homogenous array with a given key.
-	 * \warning Only outputs multiline arrays. */
+	 * Multiline (block style) by default, `multiline = false` writes a flow style `[a, b, c]`. */
 	template <typename KeyType, typename ContainerType, bool multiline=true>
-	void add_array(KeyType key, ContainerType container, uint64_t size=0)
+	void add_array(KeyType key, const ContainerType& container, uint64_t size=0)
 	{
-		//Write text
-		for(unsigned int i = 0; i < level; i++)
-			file << indent;
-		
-		file << key << " :";
+		if(size == 0)
+			size = container.size();
+
+		emit_indent();
+		emit(key);
+		emit(" :");
 		
 		if(multiline)
 		{
-			file << ' \n';
+			emit('\n');
 			level++;
-			if(size == 0)
-				size = container.size();
 			for(uint64_t i = 0; i < size; i++)
 			{
-				// Print array indent
-				for(unsigned int i = 0; i < level; i++)
-					file << indent;
-
-				//Print value
-				file << "- " << container[i] << '\n';
+				emit_indent();
+				emit("- ");
+				emit(container[i]);
+				emit('\n');
+				commit();
 			}
 			level--;
 		}
 
 		else
 		{
-			file << ' [';
-
-			for(uint64_t i = 0; i < size-1; i++)
+			emit(" [");
+			for(uint64_t i = 0; i < size; i++)
 			{
-				//Print value
-				file << container[i] << ", ";
-
+				if(i != 0)
+					emit(", ");
+				emit(container[i]);
+				commit();
 			}
-			file << container[size-1] << ']';
-		}		
+			emit("]\n");
+		}
+		commit();
 	}
 
-	//6
-	/** @brief Read a value from the file for a given key. */
-	template <typename KeyType, typename ValueType>
-	ValueType read_val(KeyType key)
+	//5.1
+	/** @brief Add a flow style array `key : [a, b, c]`, the compact form for numeric containers
+	 * (e.g. seed lists). */
+	template <typename KeyType, typename ContainerType>
+	void add_flow_array(KeyType key, const ContainerType& container, uint64_t size=0)
 	{
-		using std::vector<std::string>::iterator = piter_t;
-		piter_t found = Find(key);
-
+		add_array<KeyType, ContainerType, false>(key, container, size);
+	}
 
+	//6
+	/** @brief Reads the value of a fully qualified key (`parent.child.key`) from the parsed
+	 * document - one hash lookup and one `std::from_chars`.
+	 * Arithmetic types, `bool`, `std::string` and `std::string_view` (a view into the mapped file) are supported.
+	 * \return `fallback` if the key is missing or the value cannot be converted. */
+	template <typename ValueType>
+	ValueType read_val(std::string_view key, ValueType fallback = ValueType()) const
+	{
+		const Entry* entry = find(key);
+		if(entry == nullptr)
+			return fallback;
+		ValueType value;
+		return convert(entry->Value, value) ? value : fallback;
 	}
 
 	//7
-	/**Read an array from the file for a given key. */
-	template <typename KeyType, typename ValueType>
-	std::vector<ValueType> read_array(KeyType key)
-	{}
+	/** @brief Reads an array (block or flow style) of a fully qualified key from the parsed document.
+	 * \return Empty if the key is missing; items that cannot be converted are skipped. */
+	template <typename ValueType>
+	std::vector<ValueType> read_array(std::string_view key) const
+	{
+		std::vector<ValueType> out;
+		const Entry* entry = find(key);
+		if(entry == nullptr)
+			return out;
+
+		ValueType value;
+		if(entry->ItemCount != 0)
+		{
+			out.reserve(entry->ItemCount);
+			for(uint32_t i = 0; i < entry->ItemCount; i++)
+			{
+				if(convert(Items[entry->FirstItem + i], value))
+					out.push_back(value);
+			}
+		}
+
+		else if(entry->Value.size() >= 2 && entry->Value.front() == '[' && entry->Value.back() == ']')
+		{
+			std::string_view rest = entry->Value.substr(1, entry->Value.size() - 2);
+			out.reserve(size_t(std::count(rest.begin(), rest.end(), ',')) + 1);
+			while(!rest.empty())
+			{
+				const size_t comma = rest.find(',');
+				if(convert(trim(rest.substr(0, comma)), value))
+					out.push_back(value);
+				if(comma == std::string_view::npos)
+					break;
+				rest.remove_prefix(comma + 1);
+			}
+		}
+		return out;
+	}
 
 	//8
 	/** @brief Create a new level within the current hierarchy. */
 	template <typename KeyType>
-	void push_level(KeyType key)
+	void push_level(KeyType key, bool add_dash=false)
 	{
-		for (unsigned int i = 0; i < indent; i++)
-			file << indent;
+		emit_indent();
 		if(add_dash)
-			file << "- ";
+			emit("- ");
 
-		file << key << " :\n";
+		emit(key);
+		emit(" :\n");
+		commit();
 		level++;
 	}
 
@@ -166,12 +370,13 @@ public:
 	/** @brief Pop the current level by one unless the level is zero.*/
 	void pop_level()
 	{
-		level = (level > 0 * level - 1) + (level == 0 * 0)
+		if(level > 0)
+			level--;
 	}
 
 	//10
 	/** @brief Get the current level in the structured hierarchy. */
-	void get_level()
+	uint8_t get_level() const
 	{
 		return level;
 	}
@@ -188,7 +393,8 @@ public:
 	void doc_start()
 	{
 		reset_level();
-		file << '---' << '\n';
+		emit("---\n");
+		commit();
 	}
 
 	//13
@@ -196,43 +402,44 @@ public:
 	void doc_end()
 	{
 		reset_level();
-		file << '...' << '\n';
+		emit("...\n");
+		commit();
 	}
 
 	//-----<// YAML Non-numbers.
 	
 	//14
-	static std::string inf() { return ".inf"  }
+	static std::string inf() { return ".inf"; }
 
 	//15
-	static std::string minus_inf() { return "-.Inf" }
+	static std::string minus_inf() { return "-.Inf"; }
 
 	//16
-	static std::string nan() { return ".NAN"  }
+	static std::string nan() { return ".NAN"; }
 	//-----<// YAML Non-numbers.
 
 	//17
 	/** @brief Returns a YAML boolean value.
 	 * @param bin Binary state (C++ boolean).
 	 * @param mode  Default is "on-off", other option is "true-false". */
-	static bool boolean(bool bin, std::string mode ="true-false")
+	static std::string boolean(bool bin, std::string mode ="true-false")
 	{
 		 transform(mode.begin(), mode.end(), mode.begin(), ::tolower);
 
 		 if(mode == "on-off") 
 		 {
 		 	if(bin)
-		 		return "On"
+		 		return "On";
 		 	else
-		 		return "Off"
+		 		return "Off";
 		 }
 
 		 else
 		 {
 		 	if(bin)
-		 		return "True"
+		 		return "True";
 		 	else
-		 		return "False"
+		 		return "False";
 		 }
 	}
 
@@ -261,7 +468,11 @@ public:
 	/** @brief Add the string as a comment. */
 	void add_comment(std::string str)
 	{
-		file << "# " << str << '\n';
+		emit_indent();
+		emit("# ");
+		emit(str);
+		emit('\n');
+		commit();
 	}
 
 
@@ -269,17 +480,22 @@ public:
 	template <typename KeyType>
 	void add_key(KeyType key, bool add_dash=false)
 	{
-		for (unsigned int i = 0; i < indent; i++)
-			file << indent;
+		emit_indent();
 		if(add_dash)
-			file << "- ";
+			emit("- ");
 
-		file << key << " : ";
+		emit(key);
+		emit(" : ");
+		commit();
 	}
 
 	/** @brief Dumps the value in the file at the current place. */
 	template <typename ValueType>
-	void add(ValueType value) { file << value; }
+	void add(ValueType value)
+	{
+		emit(value);
+		commit();
+	}
 
 	//! Experimental
 
@@ -289,5 +505,212 @@ public:
 	void add_dict()
 	{ return; }
 
+private:
+//Helper Functions
+
+	static constexpr uint64_t HashSeed = 0xCBF29CE484222325ULL; //!< FNV-1a offset basis
+
+	/** @brief FNV-1a hash of `parent.key`, or of `key` for top level keys. */
+	static uint64_t key_hash(uint64_t parent, bool nested, std::string_view key)
+	{
+		uint64_t h = parent;
+		if(nested)
+			h = (h ^ uint64_t('.')) * 0x100000001B3ULL;
+		for(unsigned char c : key)
+			h = (h ^ c) * 0x100000001B3ULL;
+		return h;
+	}
+
+	/** @brief Looks up a fully qualified key, the leaf is compared to guard against hash collisions. */
+	const Entry* find(std::string_view key) const
+	{
+		const auto it = Index.find(key_hash(HashSeed, false, key));
+		if(it == Index.end())
+			return nullptr;
+		const size_t dot = key.rfind('.');
+		const std::string_view leaf = (dot == std::string_view::npos) ? key : key.substr(dot + 1);
+		return (it->second.Key == leaf) ? &it->second : nullptr;
+	}
+
+	static std::string_view trim(std::string_view str)
+	{
+		const size_t first = str.find_first_not_of(" \t");
+		if(first == std::string_view::npos)
+			return {};
+		const size_t last = str.find_last_not_of(" \t");
+		return str.substr(first, last - first + 1);
+	}
+
+	/** @brief Position of the `:` that separates key and value (followed by a blank or the line end). */
+	static size_t find_colon(std::string_view body)
+	{
+		for(size_t i = body.find(':'); i != std::string_view::npos; i = body.find(':', i + 1))
+		{
+			if(i + 1 == body.size() || body[i + 1] == ' ' || body[i + 1] == '\t')
+				return i;
+		}
+		return std::string_view::npos;
+	}
+
+	/** @brief Removes matching single or double quotes. */
+	static std::string_view unquote(std::string_view str)
+	{
+		if(str.size() >= 2 && (str.front() == '"' || str.front() == '\'') && str.back() == str.front())
+			return str.substr(1, str.size() - 2);
+		return str;
+	}
+
+	/** @brief Converts a scalar with `std::from_chars`, YAML booleans (and the `1`/`0` of direct writes) and non-numbers included. */
+	template <typename ValueType>
+	static bool convert(std::string_view str, ValueType& value)
+	{
+		if constexpr (std::is_same_v<ValueType, bool>)
+		{
+			std::string lower(str);
+			transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+			if(lower == "true" || lower == "on" || lower == "yes" || lower == "1")
+				{ value = true; return true; }
+			if(lower == "false" || lower == "off" || lower == "no" || lower == "0")
+				{ value = false; return true; }
+			return false;
+		}
+
+		else if constexpr (std::is_arithmetic_v<ValueType>)
+		{
+			if constexpr (std::is_floating_point_v<ValueType>)
+			{
+				if(str.size() == 4 || str.size() == 5)
+				{
+					std::string lower(str);
+					transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+					if(lower == ".inf" || lower == "+.inf")
+						{ value = std::numeric_limits<ValueType>::infinity(); return true; }
+					if(lower == "-.inf")
+						{ value = -std::numeric_limits<ValueType>::infinity(); return true; }
+					if(lower == ".nan")
+						{ value = std::numeric_limits<ValueType>::quiet_NaN(); return true; }
+				}
+			}
+			if(!str.empty() && str.front() == '+')
+				str.remove_prefix(1);
+			const auto result = std::from_chars(str.data(), str.data() + str.size(), value);
+			return result.ec == std::errc() && result.ptr == str.data() + str.size();
+		}
+
+		else if constexpr (std::is_same_v<ValueType, std::string_view>)
+			{ value = unquote(str); return true; }
+
+		else if constexpr (std::is_same_v<ValueType, std::string>)
+			{ value = std::string(unquote(str)); return true; }
+
+		else
+		{
+			static_assert(std::is_arithmetic_v<ValueType>, "read_val()/read_array() support arithmetic types, bool, std::string and std::string_view.");
+			return false;
+		}
+	}
+
+	/** @brief Maps the input file read-only. */
+	bool map()
+	{
+		int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+		if(fd == -1)
+			return false;
+
+		struct stat st;
+		bool mapped = false;
+		if(::fstat(fd, &st) == 0 && st.st_size > 0)
+		{
+			void* m = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+			if(m != MAP_FAILED)
+			{
+				Map = static_cast<const char*>(m);
+				MapSize = size_t(st.st_size);
+				::madvise(m, MapSize, MADV_SEQUENTIAL);
+				mapped = true;
+			}
+		}
+		::close(fd); //The mapping stays valid
+		return mapped;
+	}
+
+	void unmap()
+	{
+		if(Map != nullptr)
+			::munmap(const_cast<char*>(Map), MapSize);
+		Map = nullptr;
+		MapSize = 0;
+	}
+
+	/** @brief Appends the indentation of the current level. */
+	void emit_indent()
+	{
+		for(unsigned int i = 0; i < level; i++)
+			emit(std::string_view(indent));
+	}
+
+	void emit(char c) { Buffer.push_back(c); }
+
+	void emit(std::string_view str) { Buffer.insert(Buffer.end(), str.begin(), str.end()); }
+
+	void emit(const char* str) { emit(std::string_view(str)); }
+
+	void emit(const std::string& str) { emit(std::string_view(str)); }
+
+	/** @brief Appends a value. Without the emitter mode the text is that of `operator<<` on the file
+	 * (`1`/`0` for bools, 6 significant digits). In the emitter mode numbers are formatted with
+	 * `std::to_chars` (shortest round-trip form for floating point, YAML `.inf`/`.nan` for the
+	 * non-numbers) and bools as `true`/`false`. Character types are written as characters, other
+	 * types through `operator<<` into a reused stream. */
+	template <typename ValueType>
+	void emit(const ValueType& value)
+	{
+		if constexpr (std::is_same_v<ValueType, char> || std::is_same_v<ValueType, signed char> || std::is_same_v<ValueType, unsigned char>)
+			{ emit(static_cast<char>(value)); }
+
+		else if constexpr (std::is_same_v<ValueType, bool>)
+		{
+			if(BufferLimit == 0)
+				{ emit(value ? '1' : '0'); }
+			else
+				{ emit(value ? "true" : "false"); }
+		}
+
+		else if constexpr (std::is_arithmetic_v<ValueType>)
+		{
+			char tmp[64];
+			char* last = tmp;
+			if constexpr (std::is_floating_point_v<ValueType>)
+			{
+				if(BufferLimit == 0)
+					{ last = std::to_chars(tmp, tmp + sizeof(tmp), value, std::chars_format::general, 6).ptr; }
+				else if(std::isnan(value))
+					{ emit(nan()); return; }
+				else if(std::isinf(value))
+					{ emit(value > 0 ? inf() : minus_inf()); return; }
+				else
+					{ last = std::to_chars(tmp, tmp + sizeof(tmp), value).ptr; }
+			}
+			else
+				{ last = std::to_chars(tmp, tmp + sizeof(tmp), value).ptr; }
+			Buffer.insert(Buffer.end(), tmp, last);
+		}
+
+		else
+		{
+			Scratch.str(std::string());
+			Scratch.clear();
+			Scratch << value;
+			emit(Scratch.view());
+		}
+	}
+
+	/** @brief Writes the buffer out once it reaches the flush size (every call without the emitter mode). */
+	void commit()
+	{
+		if(Buffer.size() >= BufferLimit)
+			{ flush(); }
+	}
+
 
 };
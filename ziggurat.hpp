@@ -0,0 +1,301 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <array>
+#include <span>
+#include <limits>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+
+//Reference - "The Ziggurat Method for Generating Random Variables", G. Marsaglia, W. W. Tsang in Journal of Statistical Software Volume 5 Issue 8, 2000
+//Reference - "An Improved Ziggurat Method to Generate Normal Random Samples", J. A. Doornik, 2005
+
+
+/** @brief Precomputed layer tables of the 256-layer normal Ziggurat.
+ * The tables are built once (on first use) and shared by all distribution objects. */
+struct ZigguratTables
+{
+	static constexpr size_t Layers = 256; //!< Number of layers
+	static constexpr double R = 3.6541528853610088; //!< Start of the tail
+	static constexpr double V = 0.0049286732339746519; //!< Area of every layer
+
+	std::array<double, Layers + 1> X; //!< Right edge of every layer (decreasing)
+	std::array<double, Layers + 1> F; //!< Density at the right edge of every layer
+
+	/** @brief Returns the shared tables. */
+	static const ZigguratTables& get() {
+		static const ZigguratTables tables;
+		return tables;
+		}
+
+private:
+	ZigguratTables() {
+		const auto f = [](double x) { return std::exp(-0.5 * x * x); };
+
+		X[0] = V / f(R);
+		X[1] = R;
+		for(size_t i = 2; i < Layers; i++)
+		{
+			X[i] = std::sqrt(-2.0 * std::log(V / X[i - 1] + f(X[i - 1])));
+		}
+		X[Layers] = 0.0;
+
+		for(size_t i = 0; i <= Layers; i++)
+			{ F[i] = f(X[i]); }
+		}
+};
+
+
+/** @brief Normal distribution sampled with the Ziggurat method. A drop-in replacement
+ * for `std::normal_distribution` that can be passed as the `GaussDist` of `PRNGWrapper`.
+ * Every sample consumes 64-bit words from the engine (two draws of a 32-bit engine).
+ * Unlike `std::normal_distribution` no value is cached between calls, hence the
+ * serializable state is just the parameters and the stream is fully determined by the engine.
+ * `generate()` is the batched path: the fast (accepted) case is evaluated for a block of
+ * words in a branch-free loop that the compiler vectorizes, and the rare rejections are
+ * resolved in order, so the batch output is bit-for-bit identical to repeated `operator()` calls. */
+template <typename RealType = double>
+class ziggurat_normal_distribution
+{
+	static_assert(std::is_floating_point_v<RealType>, "ziggurat_normal_distribution requires a floating point type.");
+
+public:
+
+	using result_type = RealType;
+
+	/** @brief Parameters of the distribution - mean and standard deviation. */
+	class param_type
+	{
+		RealType Mean;
+		RealType Stddev;
+	public:
+		using distribution_type = ziggurat_normal_distribution;
+
+		explicit param_type(RealType mean = 0.0, RealType stddev = 1.0): Mean(mean), Stddev(stddev) {}
+
+		RealType mean() const { return Mean; }
+		RealType stddev() const { return Stddev; }
+
+		friend bool operator==(const param_type& lhs, const param_type& rhs) {
+			return lhs.Mean == rhs.Mean && lhs.Stddev == rhs.Stddev;
+			}
+	};
+
+private:
+
+	param_type Param; //!< Parameters of the distribution
+
+	static constexpr size_t BlockSize = 256; //!< Number of words evaluated together in `generate()`
+
+public:
+
+	//0
+	/** @brief Constructor -> Sets the mean and standard deviation. */
+	explicit ziggurat_normal_distribution(RealType mean = 0.0, RealType stddev = 1.0): Param(mean, stddev) {}
+
+	explicit ziggurat_normal_distribution(const param_type& param): Param(param) {}
+
+	//1
+	/** @brief The distribution does not cache values, hence there is nothing to reset. */
+	void reset() {}
+
+	//2
+	RealType mean() const { return Param.mean(); }
+	RealType stddev() const { return Param.stddev(); }
+	param_type param() const { return Param; }
+	void param(const param_type& param) { Param = param; }
+	result_type min() const { return std::numeric_limits<RealType>::lowest(); }
+	result_type max() const { return std::numeric_limits<RealType>::max(); }
+
+	//3
+	/** @brief Draw one normally distributed number. */
+	template <class URBG>
+	__attribute__((flatten)) result_type operator()(URBG& engine) {
+		return (*this)(engine, Param);
+		}
+
+	/** @brief Draw one normally distributed number with the passed parameters. */
+	template <class URBG>
+	__attribute__((flatten)) result_type operator()(URBG& engine, const param_type& param) {
+		EngineWords<URBG> source{engine};
+		const std::uint64_t bits = source();
+		return static_cast<RealType>(param.mean() + param.stddev() * sample(bits, source));
+		}
+
+	//4
+	/** @brief Batched path. Fills the span with the same numbers that repeated calls of
+	 * `operator()` would return and leaves the engine in the same state. */
+	template <class URBG>
+	void generate(URBG& engine, std::span<RealType> out) {
+		generate(engine, out, Param);
+		}
+
+	template <class URBG>
+	void generate(URBG& engine, std::span<RealType> out, const param_type& param) {
+		const auto& tables = ZigguratTables::get();
+		alignas(64) std::uint64_t words[BlockSize];
+		alignas(64) double candidate[BlockSize];
+		alignas(64) std::uint8_t accepted[BlockSize];
+
+		EngineWords<URBG> engine_source{engine};
+		const double mean = param.mean();
+		const double stddev = param.stddev();
+		size_t n = 0;
+
+		while(n < out.size())
+		{
+			//Every output consumes at least one word, hence never buffer more words than outputs left.
+			size_t block = out.size() - n;
+			if(block > BlockSize)
+				{ block = BlockSize; }
+
+			for(size_t k = 0; k < block; k++)
+				{ words[k] = engine_source(); }
+
+			//Fast path - branch-free and vectorizable.
+			for(size_t k = 0; k < block; k++)
+			{
+				const size_t i = words[k] & 0xff;
+				const double x = symmetric_unit(words[k]) * tables.X[i];
+				candidate[k] = x;
+				accepted[k] = std::fabs(x) < tables.X[i + 1];
+			}
+
+			//Resolve in stream order. Rejections read the following buffered words first.
+			BufferedWords<URBG> source{words, block, 0, engine_source};
+			while(source.Pos < block && n < out.size())
+			{
+				const size_t k = source.Pos++;
+				const double x = accepted[k] ? candidate[k] : sample(words[k], source);
+				out[n++] = static_cast<RealType>(mean + stddev * x);
+			}
+		}
+		}
+
+	/** @brief Distributions compare equal if their parameters are equal. */
+	friend bool operator==(const ziggurat_normal_distribution& lhs, const ziggurat_normal_distribution& rhs) {
+		return lhs.Param == rhs.Param;
+		}
+
+	/** @brief Writes the distribution state (mean and standard deviation) as text. */
+	template <class CharT, class Traits>
+	friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const ziggurat_normal_distribution& dist) {
+		const auto flags = os.flags();
+		const auto precision = os.precision();
+		os.flags(std::ios_base::scientific | std::ios_base::left);
+		os.precision(std::numeric_limits<RealType>::max_digits10);
+
+		os << dist.mean() << os.widen(' ') << dist.stddev();
+
+		os.flags(flags);
+		os.precision(precision);
+		return os;
+		}
+
+	/** @brief Reads the distribution state written by `operator<<`. */
+	template <class CharT, class Traits>
+	friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, ziggurat_normal_distribution& dist) {
+		const auto flags = is.flags();
+		is.flags(std::ios_base::dec | std::ios_base::skipws);
+
+		RealType mean, stddev;
+		if(is >> mean >> stddev)
+			{ dist.param(param_type(mean, stddev)); }
+
+		is.flags(flags);
+		return is;
+		}
+
+private:
+//Helper Functions
+
+	/** @brief Draws 64-bit words from an engine with a 32-bit or 64-bit range. */
+	template <class URBG>
+	struct EngineWords
+	{
+		URBG& Engine;
+
+		std::uint64_t operator()() {
+			using engine_t = std::remove_reference_t<URBG>;
+			static_assert(engine_t::min() == 0, "ziggurat_normal_distribution requires an engine with min() == 0.");
+
+			if constexpr (engine_t::max() == std::numeric_limits<std::uint64_t>::max())
+				{ return static_cast<std::uint64_t>(Engine()); }
+			else
+			{
+				static_assert(engine_t::max() == std::numeric_limits<std::uint32_t>::max(),
+				              "ziggurat_normal_distribution requires an engine with a 32-bit or 64-bit range.");
+				const std::uint64_t hi = static_cast<std::uint32_t>(Engine());
+				const std::uint64_t lo = static_cast<std::uint32_t>(Engine());
+				return (hi << 32) | lo;
+			}
+			}
+	};
+
+	/** @brief Reads the remaining words of a block and then falls back to the engine. */
+	template <class URBG>
+	struct BufferedWords
+	{
+		const std::uint64_t* Words;
+		size_t Size;
+		size_t Pos;
+		EngineWords<URBG>& Engine;
+
+		std::uint64_t operator()() {
+			if(Pos < Size)
+				{ return Words[Pos++]; }
+			return Engine();
+			}
+	};
+
+	/** @brief Maps the upper 53 bits to (-1, 1). The low 8 bits select the layer. */
+	static inline double symmetric_unit(std::uint64_t bits) __attribute__((always_inline)) {
+		return 2.0 * (static_cast<double>(bits >> 11) * 0x1.0p-53) - 1.0;
+		}
+
+	/** @brief Maps the upper 53 bits to [0, 1). */
+	static inline double unit(std::uint64_t bits) __attribute__((always_inline)) {
+		return static_cast<double>(bits >> 11) * 0x1.0p-53;
+		}
+
+	/** @brief Maps the upper 52 bits to (0, 1). */
+	static inline double open_unit(std::uint64_t bits) __attribute__((always_inline)) {
+		return (static_cast<double>(bits >> 12) + 0.5) * 0x1.0p-52;
+		}
+
+	/** @brief Standard normal sample for the first word `bits`. Further words are read from `source`. */
+	template <class Source>
+	static double sample(std::uint64_t bits, Source& source) {
+		const auto& tables = ZigguratTables::get();
+
+		while(true)
+		{
+			const size_t i = bits & 0xff;
+			const double u = symmetric_unit(bits);
+			const double x = u * tables.X[i];
+
+			if(std::fabs(x) < tables.X[i + 1])
+				{ return x; }
+
+			if(i == 0) //Base layer - sample from the tail beyond R.
+			{
+				double tx, ty;
+				do
+				{
+					tx = std::log(open_unit(source())) / ZigguratTables::R;
+					ty = std::log(open_unit(source()));
+				} while(-2.0 * ty < tx * tx);
+
+				return (u < 0) ? tx - ZigguratTables::R : ZigguratTables::R - tx;
+			}
+
+			if(tables.F[i + 1] + (tables.F[i] - tables.F[i + 1]) * unit(source()) < std::exp(-0.5 * x * x))
+				{ return x; }
+
+			bits = source();
+		}
+		}
+};